@@ -8,13 +8,27 @@
 #ifndef CHAN_H
 #define CHAN_H
 
-#include "CircBuf.h"
-#include <semaphore.h>
+#include "ChanCore.h"
+#include "WaitList.h"
 #include <iostream>
+#include <utility>
+#include <chrono>
+#include <cstdint>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/eventfd.h>
 
 namespace Circular
 {
 
+class Selector;
+
+template<typename T, std::size_t N, typename E>
+class PopAwaiter;
+
+template<typename T, std::size_t N, typename E>
+class PushAwaiter;
+
 template<typename T, std::size_t N>
 class Chan;
 
@@ -25,21 +39,43 @@ template<typename T, std::size_t N>
 class Chan
 {
     friend std::ostream &operator<< <T, N>(std::ostream &, Chan &);
+    friend class Selector;
+    template<typename U, std::size_t M, typename E>
+    friend class PopAwaiter;
+    template<typename U, std::size_t M, typename E>
+    friend class PushAwaiter;
 public:
-    Chan();
+    static constexpr std::size_t defaultSpin{256};
+    explicit Chan(std::size_t spin = defaultSpin, bool pollable = false);
     Chan(const Chan &) = delete;
     Chan(Chan &&) = delete;
     virtual ~Chan();
     Chan &operator=(const Chan &) = delete;
     Chan &operator=(Chan &&) = delete;
+    std::size_t spin() const;
+    void spin(std::size_t);
     std::size_t count() const;
     std::size_t space() const;
     std::size_t pop(T &&);
     std::size_t push(T &&);
+    std::size_t tryPop(T &&);
+    std::size_t tryPush(T &&);
+    std::size_t popUntil(T &&, const std::chrono::steady_clock::time_point &);
+    std::size_t pushUntil(T &&, const std::chrono::steady_clock::time_point &);
+    std::size_t popN(T *, std::size_t);
+    std::size_t pushN(T *, std::size_t);
+    std::size_t popAll(T *, std::size_t);
+    int pollFd() const;
+    void pollClear();
 protected:
-    Circular::Moving::CircBuf<T, N> _circBuf;
-    sem_t _rdSem;
-    sem_t _wrSem;
+    std::size_t notifyRd(std::size_t);
+    std::size_t notifyWr(std::size_t);
+    ChanCore<T, N> _core;
+    WaitList _rdWaitList;
+    WaitList _wrWaitList;
+    std::size_t _spin;
+    int _pollFd{-1};
+    alignas(64) std::atomic<bool> _pollSignalled{false};
 };
 
 #include "Chan.hpp"
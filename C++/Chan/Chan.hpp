@@ -5,110 +5,222 @@
 // |                          |
 // +--------------------------+
 
-// A queue implemented using an underlying moving circular buffer and
-// semaphores to block read operations when the queue is empty and write
-// operations when the queue is full.
-
-#include <utility>
-#include <cerrno>
+// A queue implemented using an underlying multiple producer, multiple consumer
+// moving circular buffer and event counts to block read operations when the
+// queue is empty and write operations when the queue is full. These and the
+// operations on them are kept in a ChanCore, which ShmChan shares.
+//
+// Any number of threads may push and pop concurrently. A blocked operation first
+// retries for up to spin iterations, pausing the CPU between attempts, and then
+// parks on a futex. A successful operation only wakes the other side when a
+// thread is actually parked, so an uncontended push or pop makes no system calls.
+//
+// tryPop and tryPush never block, and popUntil and pushUntil give up when a
+// steady clock deadline expires. These report failure by returning zero.
+//
+// popN, pushN and popAll move a run of items with a single claim on the
+// circular buffer and a single notification of the other side.
+//
+// A channel constructed as pollable also owns an eventfd that becomes readable
+// when items are pushed, so that consumers can wait for it with poll, select or
+// epoll. Only the first push after the consumer calls pollClear writes to the
+// eventfd, so a burst of pushes causes a single wakeup. A consumer should call
+// pollClear when the eventfd becomes readable and then call tryPop until the
+// channel is empty.
+//
+// Coroutines wait for a channel with the awaiters in ChanAwait.h, which
+// register on a wait list instead of parking a thread and are woken alongside
+// the threads parked on the event counts.
+//
+// A slot may still be in use by a thread that claimed it on the previous lap of
+// the circular buffer, in which case the operation waits for that thread to
+// finish, which notifies the event count.
 
 template<typename T, std::size_t N>
 std::ostream &operator<<(std::ostream &ostr, Chan<T, N> &ch)
 {
-    return ostr << ch._circBuf;
+    return ostr << ch._core;
 }
 
 template<typename T, std::size_t N>
-Chan<T, N>::Chan() : _circBuf()
+Chan<T, N>::Chan(std::size_t spin, bool pollable) : _core(), _spin{spin}
 {
-    int ret{0};
-
-    ret = sem_init(&_rdSem, 0, 0);
-    if (ret < 0)
+    if (pollable)
     {
-        throw errno;
+        _pollFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (_pollFd < 0)
+        {
+            throw errno;
+        }
     }
-    ret = sem_init(&_wrSem, 0, N - 1);
-    if (ret < 0)
+}
+
+template<typename T, std::size_t N>
+Chan<T, N>::~Chan()
+{
+    if (_pollFd >= 0)
     {
-        sem_destroy(&_rdSem);
-        throw errno;
+        close(_pollFd);
     }
 }
 
+// number of attempts made before parking a blocked operation
 template<typename T, std::size_t N>
-Chan<T, N>::~Chan()
+std::size_t Chan<T, N>::spin() const
 {
-    sem_destroy(&_wrSem);
-    sem_destroy(&_rdSem);
+    return _spin;
+}
+
+template<typename T, std::size_t N>
+void Chan<T, N>::spin(std::size_t spin)
+{
+    _spin = spin;
 }
 
 // total number of items present in the channel
 template<typename T, std::size_t N>
 std::size_t Chan<T, N>::count() const
 {
-    return _circBuf.count();
+    return _core.count();
 }
 
 // total space available for items in the channel
 template<typename T, std::size_t N>
 std::size_t Chan<T, N>::space() const
 {
-    return _circBuf.space();
+    return _core.space();
 }
 
 // returns number of items popped
 template<typename T, std::size_t N>
 std::size_t Chan<T, N>::pop(T &&val)
 {
-    std::size_t num{0};
-    int ret{0};
+    return notifyWr(_core.pop(std::forward<T>(val), _spin));
+}
+
+// returns number of items pushed
+template<typename T, std::size_t N>
+std::size_t Chan<T, N>::push(T &&val)
+{
+    return notifyRd(_core.push(std::forward<T>(val), _spin));
+}
+
+// returns number of items popped (zero if the channel is empty)
+template<typename T, std::size_t N>
+std::size_t Chan<T, N>::tryPop(T &&val)
+{
+    return notifyWr(_core.tryPop(std::forward<T>(val)));
+}
+
+// returns number of items pushed (zero if the channel is full)
+template<typename T, std::size_t N>
+std::size_t Chan<T, N>::tryPush(T &&val)
+{
+    return notifyRd(_core.tryPush(std::forward<T>(val)));
+}
+
+// returns number of items popped (zero if the deadline expired)
+template<typename T, std::size_t N>
+std::size_t Chan<T, N>::popUntil(T &&val, const std::chrono::steady_clock::time_point &deadline)
+{
+    return notifyWr(_core.popUntil(std::forward<T>(val), _spin, deadline));
+}
+
+// returns number of items pushed (zero if the deadline expired)
+template<typename T, std::size_t N>
+std::size_t Chan<T, N>::pushUntil(T &&val, const std::chrono::steady_clock::time_point &deadline)
+{
+    return notifyRd(_core.pushUntil(std::forward<T>(val), _spin, deadline));
+}
+
+// block until at least one item is present and then pop as many as possible
+// returns number of items popped
+template<typename T, std::size_t N>
+std::size_t Chan<T, N>::popN(T *buf, std::size_t len)
+{
+    return notifyWr(_core.popN(buf, len, _spin));
+}
+
+// block until at least one slot is available and then push as many as possible
+// returns number of items pushed
+template<typename T, std::size_t N>
+std::size_t Chan<T, N>::pushN(T *buf, std::size_t len)
+{
+    return notifyRd(_core.pushN(buf, len, _spin));
+}
 
-    for (;;)
+// block until at least one item is present and then pop items until the
+// channel is empty or len items have been popped
+// returns number of items popped
+template<typename T, std::size_t N>
+std::size_t Chan<T, N>::popAll(T *buf, std::size_t len)
+{
+    return notifyWr(_core.popAll(buf, len, _spin));
+}
+
+// eventfd that becomes readable when items are present
+// (-1 if the channel is not pollable)
+template<typename T, std::size_t N>
+int Chan<T, N>::pollFd() const
+{
+    return _pollFd;
+}
+
+// make the eventfd unreadable until the next push
+// (any items already present must be popped after calling this)
+template<typename T, std::size_t N>
+void Chan<T, N>::pollClear()
+{
+    std::uint64_t val{0};
+
+    if (_pollFd < 0)
     {
-        ret = sem_wait(&_rdSem);
-        if (ret == 0)
-        {
-            break;
-        }
-        if (errno != EINTR)
-        {
-            return 0;
-        }
+        return;
     }
-    num = _circBuf.pop(std::forward<T>(val));
-    ret = sem_post(&_wrSem);
-    if (ret < 0)
+    while (read(_pollFd, &val, sizeof(val)) < 0 && errno == EINTR)
     {
-        return 0;
     }
-    return num;
+    _pollSignalled.store(false, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
 }
 
-// returns number of items pushed
+// wake the coroutines and the poller waiting for items after num items have
+// been pushed (the core has already woken the threads)
+// returns num
 template<typename T, std::size_t N>
-std::size_t Chan<T, N>::push(T &&val)
+std::size_t Chan<T, N>::notifyRd(std::size_t num)
 {
-    std::size_t num{0};
-    int ret{0};
-
-    for (;;)
+    if (num == 0)
     {
-        ret = sem_wait(&_wrSem);
-        if (ret == 0)
-        {
-            break;
-        }
-        if (errno != EINTR)
-        {
-            return 0;
-        }
+        return 0;
     }
-    num = _circBuf.push(std::forward<T>(val));
-    ret = sem_post(&_rdSem);
-    if (ret < 0)
+    _rdWaitList.notify(num);
+    if (_pollFd < 0)
+    {
+        return num;
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_pollSignalled.load(std::memory_order_relaxed) || _pollSignalled.exchange(true, std::memory_order_acq_rel))
+    {
+        return num;
+    }
+    std::uint64_t one{1};
+    while (write(_pollFd, &one, sizeof(one)) < 0 && errno == EINTR)
+    {
+    }
+    return num;
+}
+
+// wake the coroutines waiting for space after num items have been popped
+// (the core has already woken the threads)
+// returns num
+template<typename T, std::size_t N>
+std::size_t Chan<T, N>::notifyWr(std::size_t num)
+{
+    if (num == 0)
     {
         return 0;
     }
+    _wrWaitList.notify(num);
     return num;
 }
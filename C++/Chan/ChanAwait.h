@@ -0,0 +1,71 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#ifndef CHAN_AWAIT_H
+#define CHAN_AWAIT_H
+
+#include "Chan.h"
+#include "WaitList.h"
+#include <coroutine>
+#include <concepts>
+#include <functional>
+#include <utility>
+
+namespace Circular
+{
+
+template<typename E>
+concept Executor = requires(E &exec, std::function<void()> func)
+{
+    exec.submit(std::move(func));
+};
+
+template<typename T, std::size_t N, typename E>
+class PopAwaiter : public WaitList::Waiter
+{
+public:
+    PopAwaiter(Chan<T, N> &, E &);
+    bool await_ready();
+    bool await_suspend(std::coroutine_handle<>);
+    T await_resume();
+    void wake() override;
+protected:
+    bool park();
+    Chan<T, N> &_chan;
+    E &_exec;
+    std::coroutine_handle<> _handle;
+    T _val{};
+};
+
+template<typename T, std::size_t N, typename E>
+class PushAwaiter : public WaitList::Waiter
+{
+public:
+    PushAwaiter(Chan<T, N> &, T &&, E &);
+    bool await_ready();
+    bool await_suspend(std::coroutine_handle<>);
+    void await_resume();
+    void wake() override;
+protected:
+    bool park();
+    Chan<T, N> &_chan;
+    E &_exec;
+    std::coroutine_handle<> _handle;
+    T _val;
+};
+
+template<typename T, std::size_t N, Executor E>
+PopAwaiter<T, N, E> popAsync(Chan<T, N> &, E &);
+
+template<typename T, std::size_t N, Executor E>
+PushAwaiter<T, N, E> pushAsync(Chan<T, N> &, T &&, E &);
+
+#include "ChanAwait.hpp"
+
+}  // namespace Circular
+
+#endif
@@ -0,0 +1,168 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+// Awaiters that let a coroutine pop from or push to a channel without
+// blocking the thread that runs it:
+//
+//     T val{co_await popAsync(chan, exec)};
+//     co_await pushAsync(chan, std::move(val), exec);
+//
+// An operation that can complete at once does so without suspending the
+// coroutine. Otherwise the coroutine is suspended and its awaiter is added to
+// the wait list of the channel, and the next push or pop submits a retry to
+// the executor, which resumes the coroutine once the operation completes. An
+// executor is any object with a submit function that accepts a
+// std::function<void()> and calls it later, on any thread.
+//
+// A retry that loses the item or slot to another consumer or producer adds
+// the awaiter to the wait list again, so a suspended coroutine is never
+// resumed without completing its operation.
+//
+// The channel and the executor must outlive every suspended coroutine.
+
+template<typename T, std::size_t N, typename E>
+PopAwaiter<T, N, E>::PopAwaiter(Chan<T, N> &chan, E &exec) : _chan(chan), _exec(exec) {}
+
+// pop without suspending if the channel is not empty
+template<typename T, std::size_t N, typename E>
+bool PopAwaiter<T, N, E>::await_ready()
+{
+    return _chan.tryPop(std::move(_val)) == 1;
+}
+
+// returns false to resume at once if an item was popped while registering
+template<typename T, std::size_t N, typename E>
+bool PopAwaiter<T, N, E>::await_suspend(std::coroutine_handle<> handle)
+{
+    _handle = handle;
+    return park();
+}
+
+template<typename T, std::size_t N, typename E>
+T PopAwaiter<T, N, E>::await_resume()
+{
+    return std::move(_val);
+}
+
+template<typename T, std::size_t N, typename E>
+void PopAwaiter<T, N, E>::wake()
+{
+    _exec.submit([this]()
+                 {
+                     if (_chan.tryPop(std::move(_val)) == 1 || !park())
+                     {
+                         _handle.resume();
+                     }
+                 });
+}
+
+// add the awaiter to the wait list until the channel is not empty
+// (the awaiter may be woken and resumed on another thread as soon as it
+// commits, so it is not touched again after park returns true)
+// returns false if an item was popped instead
+template<typename T, std::size_t N, typename E>
+bool PopAwaiter<T, N, E>::park()
+{
+    for (;;)
+    {
+        _chan._rdWaitList.add(this);
+        if (_chan.count() > 0 && _chan._rdWaitList.remove(this))
+        {
+            if (_chan.tryPop(std::move(_val)) == 1)
+            {
+                return false;
+            }
+            continue;
+        }
+        if (commit())
+        {
+            return true;
+        }
+        // notified before committing, so no retry is coming
+        if (_chan.tryPop(std::move(_val)) == 1)
+        {
+            return false;
+        }
+    }
+}
+
+template<typename T, std::size_t N, typename E>
+PushAwaiter<T, N, E>::PushAwaiter(Chan<T, N> &chan, T &&val, E &exec) : _chan(chan), _exec(exec), _val(std::move(val)) {}
+
+// push without suspending if the channel is not full
+template<typename T, std::size_t N, typename E>
+bool PushAwaiter<T, N, E>::await_ready()
+{
+    return _chan.tryPush(std::move(_val)) == 1;
+}
+
+// returns false to resume at once if the item was pushed while registering
+template<typename T, std::size_t N, typename E>
+bool PushAwaiter<T, N, E>::await_suspend(std::coroutine_handle<> handle)
+{
+    _handle = handle;
+    return park();
+}
+
+template<typename T, std::size_t N, typename E>
+void PushAwaiter<T, N, E>::await_resume() {}
+
+template<typename T, std::size_t N, typename E>
+void PushAwaiter<T, N, E>::wake()
+{
+    _exec.submit([this]()
+                 {
+                     if (_chan.tryPush(std::move(_val)) == 1 || !park())
+                     {
+                         _handle.resume();
+                     }
+                 });
+}
+
+// add the awaiter to the wait list until the channel is not full
+// (the awaiter may be woken and resumed on another thread as soon as it
+// commits, so it is not touched again after park returns true)
+// returns false if the item was pushed instead
+template<typename T, std::size_t N, typename E>
+bool PushAwaiter<T, N, E>::park()
+{
+    for (;;)
+    {
+        _chan._wrWaitList.add(this);
+        if (_chan.space() > 0 && _chan._wrWaitList.remove(this))
+        {
+            if (_chan.tryPush(std::move(_val)) == 1)
+            {
+                return false;
+            }
+            continue;
+        }
+        if (commit())
+        {
+            return true;
+        }
+        // notified before committing, so no retry is coming
+        if (_chan.tryPush(std::move(_val)) == 1)
+        {
+            return false;
+        }
+    }
+}
+
+// returns an awaiter that pops an item from the channel
+template<typename T, std::size_t N, Executor E>
+PopAwaiter<T, N, E> popAsync(Chan<T, N> &chan, E &exec)
+{
+    return PopAwaiter<T, N, E>(chan, exec);
+}
+
+// returns an awaiter that pushes val into the channel
+template<typename T, std::size_t N, Executor E>
+PushAwaiter<T, N, E> pushAsync(Chan<T, N> &chan, T &&val, E &exec)
+{
+    return PushAwaiter<T, N, E>(chan, std::move(val), exec);
+}
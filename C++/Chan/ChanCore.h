@@ -0,0 +1,60 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#ifndef CHAN_CORE_H
+#define CHAN_CORE_H
+
+#include "MpmcCircBuf.h"
+#include "EventCount.h"
+#include <iostream>
+#include <utility>
+#include <chrono>
+
+namespace Circular
+{
+
+template<typename T, std::size_t N>
+class ChanCore;
+
+template<typename T, std::size_t N>
+std::ostream &operator<<(std::ostream &, ChanCore<T, N> &);
+
+template<typename T, std::size_t N>
+class ChanCore final
+{
+    friend std::ostream &operator<< <T, N>(std::ostream &, ChanCore &);
+public:
+    explicit ChanCore(bool shared = false);
+    ChanCore(const ChanCore &) = delete;
+    ChanCore(ChanCore &&) = delete;
+    ~ChanCore() = default;
+    ChanCore &operator=(const ChanCore &) = delete;
+    ChanCore &operator=(ChanCore &&) = delete;
+    EventCount &rdEvent();
+    EventCount &wrEvent();
+    std::size_t count() const;
+    std::size_t space() const;
+    std::size_t pop(T &&, std::size_t);
+    std::size_t push(T &&, std::size_t);
+    std::size_t tryPop(T &&);
+    std::size_t tryPush(T &&);
+    std::size_t popUntil(T &&, std::size_t, const std::chrono::steady_clock::time_point &);
+    std::size_t pushUntil(T &&, std::size_t, const std::chrono::steady_clock::time_point &);
+    std::size_t popN(T *, std::size_t, std::size_t);
+    std::size_t pushN(T *, std::size_t, std::size_t);
+    std::size_t popAll(T *, std::size_t, std::size_t);
+private:
+    Circular::Moving::MpmcCircBuf<T, N> _circBuf;
+    EventCount _rdEvent;
+    EventCount _wrEvent;
+};
+
+#include "ChanCore.hpp"
+
+}  // namespace Circular
+
+#endif
@@ -0,0 +1,179 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+// The state and the operations shared by Chan and ShmChan: a multiple producer,
+// multiple consumer moving circular buffer and the event counts that block read
+// operations when it is empty and write operations when it is full.
+//
+// Every operation notifies the event count of the other side when it moves an
+// item and returns the number of items moved, so that a channel that has other
+// waiters to wake can do so after it.
+//
+// ShmChan places the core in shared memory, where it is constructed by one
+// process and used by others that map it at different addresses. It therefore
+// has no virtual members, holds no pointers and is never destroyed there, and
+// neither are the circular buffer and the event counts that it contains.
+
+template<typename T, std::size_t N>
+std::ostream &operator<<(std::ostream &ostr, ChanCore<T, N> &core)
+{
+    return ostr << core._circBuf;
+}
+
+template<typename T, std::size_t N>
+ChanCore<T, N>::ChanCore(bool shared) : _circBuf(), _rdEvent{shared}, _wrEvent{shared} {}
+
+// event count notified when items are pushed
+template<typename T, std::size_t N>
+EventCount &ChanCore<T, N>::rdEvent()
+{
+    return _rdEvent;
+}
+
+// event count notified when items are popped
+template<typename T, std::size_t N>
+EventCount &ChanCore<T, N>::wrEvent()
+{
+    return _wrEvent;
+}
+
+// total number of items present in the channel
+template<typename T, std::size_t N>
+std::size_t ChanCore<T, N>::count() const
+{
+    return _circBuf.count();
+}
+
+// total space available for items in the channel
+template<typename T, std::size_t N>
+std::size_t ChanCore<T, N>::space() const
+{
+    return _circBuf.space();
+}
+
+// returns number of items popped
+template<typename T, std::size_t N>
+std::size_t ChanCore<T, N>::pop(T &&val, std::size_t spin)
+{
+    _rdEvent.await([this, &val]() {return _circBuf.pop(std::forward<T>(val)) == 1;}, spin);
+    _wrEvent.notify(1);
+    return 1;
+}
+
+// returns number of items pushed
+template<typename T, std::size_t N>
+std::size_t ChanCore<T, N>::push(T &&val, std::size_t spin)
+{
+    _wrEvent.await([this, &val]() {return _circBuf.push(std::forward<T>(val)) == 1;}, spin);
+    _rdEvent.notify(1);
+    return 1;
+}
+
+// returns number of items popped (zero if the channel is empty)
+template<typename T, std::size_t N>
+std::size_t ChanCore<T, N>::tryPop(T &&val)
+{
+    if (_circBuf.pop(std::forward<T>(val)) == 0)
+    {
+        return 0;
+    }
+    _wrEvent.notify(1);
+    return 1;
+}
+
+// returns number of items pushed (zero if the channel is full)
+template<typename T, std::size_t N>
+std::size_t ChanCore<T, N>::tryPush(T &&val)
+{
+    if (_circBuf.push(std::forward<T>(val)) == 0)
+    {
+        return 0;
+    }
+    _rdEvent.notify(1);
+    return 1;
+}
+
+// returns number of items popped (zero if the deadline expired)
+template<typename T, std::size_t N>
+std::size_t ChanCore<T, N>::popUntil(T &&val, std::size_t spin, const std::chrono::steady_clock::time_point &deadline)
+{
+    if (!_rdEvent.awaitUntil([this, &val]() {return _circBuf.pop(std::forward<T>(val)) == 1;}, spin, deadline))
+    {
+        return 0;
+    }
+    _wrEvent.notify(1);
+    return 1;
+}
+
+// returns number of items pushed (zero if the deadline expired)
+template<typename T, std::size_t N>
+std::size_t ChanCore<T, N>::pushUntil(T &&val, std::size_t spin, const std::chrono::steady_clock::time_point &deadline)
+{
+    if (!_wrEvent.awaitUntil([this, &val]() {return _circBuf.push(std::forward<T>(val)) == 1;}, spin, deadline))
+    {
+        return 0;
+    }
+    _rdEvent.notify(1);
+    return 1;
+}
+
+// block until at least one item is present and then pop as many as possible
+// returns number of items popped
+template<typename T, std::size_t N>
+std::size_t ChanCore<T, N>::popN(T *buf, std::size_t len, std::size_t spin)
+{
+    std::size_t num{0};
+
+    if (len == 0)
+    {
+        return 0;
+    }
+    _rdEvent.await([this, buf, len, &num]() {return (num = _circBuf.read(buf, len)) > 0;}, spin);
+    _wrEvent.notify(num);
+    return num;
+}
+
+// block until at least one slot is available and then push as many as possible
+// returns number of items pushed
+template<typename T, std::size_t N>
+std::size_t ChanCore<T, N>::pushN(T *buf, std::size_t len, std::size_t spin)
+{
+    std::size_t num{0};
+
+    if (len == 0)
+    {
+        return 0;
+    }
+    _wrEvent.await([this, buf, len, &num]() {return (num = _circBuf.write(buf, len)) > 0;}, spin);
+    _rdEvent.notify(num);
+    return num;
+}
+
+// block until at least one item is present and then pop items until the
+// channel is empty or len items have been popped
+// returns number of items popped
+template<typename T, std::size_t N>
+std::size_t ChanCore<T, N>::popAll(T *buf, std::size_t len, std::size_t spin)
+{
+    std::size_t num{0};
+    std::size_t ret{0};
+
+    if (len == 0)
+    {
+        return 0;
+    }
+    _rdEvent.await([this, buf, len, &num]() {return (num = _circBuf.read(buf, len)) > 0;}, spin);
+    do
+    {
+        buf += num;
+        len -= num;
+        ret += num;
+    }
+    while (len > 0 && (num = _circBuf.read(buf, len)) > 0);
+    _wrEvent.notify(ret);
+    return ret;
+}
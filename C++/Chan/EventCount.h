@@ -0,0 +1,61 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#ifndef EVENT_COUNT_H
+#define EVENT_COUNT_H
+
+#include <atomic>
+#include <cstdint>
+#include <chrono>
+#include <cerrno>
+#include <climits>
+#include <ctime>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+namespace Circular
+{
+
+class EventCount final
+{
+public:
+    explicit EventCount(bool shared = false);
+    EventCount(const EventCount &) = delete;
+    EventCount(EventCount &&) = delete;
+    ~EventCount() = default;
+    EventCount &operator=(const EventCount &) = delete;
+    EventCount &operator=(EventCount &&) = delete;
+    static void pause();
+    bool shared() const;
+    std::uint32_t waiters() const;
+    std::uint32_t prepareWait();
+    void cancelWait();
+    void wait(std::uint32_t);
+    bool waitUntil(std::uint32_t, const std::chrono::steady_clock::time_point &);
+    static void waitAny(EventCount *const *, const std::uint32_t *, std::size_t);
+    static bool waitAnyUntil(EventCount *const *, const std::uint32_t *, std::size_t, const std::chrono::steady_clock::time_point &);
+    void notify(std::size_t);
+    void notifyOne();
+    void notifyAll();
+    template<typename F>
+    void await(F &&, std::size_t);
+    template<typename F>
+    bool awaitUntil(F &&, std::size_t, const std::chrono::steady_clock::time_point &);
+protected:
+    static struct timespec monotonic(const std::chrono::steady_clock::time_point &);
+    static bool waitAny(EventCount *const *, const std::uint32_t *, std::size_t, const struct timespec *);
+    alignas(64) std::atomic<std::uint32_t> _epoch{0};
+    std::atomic<std::uint32_t> _waiters{0};
+    int _private;
+};
+
+#include "EventCount.hpp"
+
+}  // namespace Circular
+
+#endif
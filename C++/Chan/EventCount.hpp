@@ -0,0 +1,268 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+// A condition that threads can wait on without a lock, built on a futex.
+//
+// A waiter registers by calling prepareWait, which returns the current epoch,
+// then checks its condition again and either calls cancelWait (the condition
+// became true) or wait (the condition is still false). wait parks the thread
+// on the epoch until it changes.
+//
+// waitAny parks on several event counts at once using futex_waitv, each of which
+// must have been prepared by the caller.
+//
+// A notifier first makes the condition true and then calls notify, notifyOne
+// or notifyAll. These only advance the epoch and make a system call when at least
+// one waiter is registered, so notifying a condition that nobody waits on costs
+// a fence and a load.
+//
+// The sequentially consistent fences in prepareWait and notify guarantee that
+// either the waiter sees the condition become true when it checks again or the
+// notifier sees the registered waiter.
+//
+// An event count constructed as shared uses futexes that are not private to the
+// process, so that it can be placed in shared memory and waited on and notified
+// by several processes, each of which may map it at a different address. For
+// the same reason an event count has no virtual members.
+
+inline EventCount::EventCount(bool shared) : _private{shared ? 0 : FUTEX_PRIVATE_FLAG} {}
+
+inline void EventCount::pause()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
+// the futexes are shared between processes
+inline bool EventCount::shared() const
+{
+    return _private == 0;
+}
+
+// number of registered waiters
+inline std::uint32_t EventCount::waiters() const
+{
+    return _waiters.load(std::memory_order_relaxed);
+}
+
+// returns the key to pass to wait
+inline std::uint32_t EventCount::prepareWait()
+{
+    _waiters.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return _epoch.load(std::memory_order_acquire);
+}
+
+inline void EventCount::cancelWait()
+{
+    _waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// park until the epoch differs from the key
+// (may return spuriously, so the caller must check its condition again)
+inline void EventCount::wait(std::uint32_t key)
+{
+    if (_epoch.load(std::memory_order_acquire) == key)
+    {
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&_epoch), FUTEX_WAIT | _private, key, nullptr, nullptr, 0);
+    }
+    _waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// park until the epoch differs from the key or the deadline expires
+// (may return spuriously, so the caller must check its condition again)
+// returns false if the deadline expired
+inline bool EventCount::waitUntil(std::uint32_t key, const std::chrono::steady_clock::time_point &deadline)
+{
+    long ret{0};
+
+    if (_epoch.load(std::memory_order_acquire) == key)
+    {
+        struct timespec ts{monotonic(deadline)};
+        ret = syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&_epoch), FUTEX_WAIT_BITSET | _private, key, &ts, nullptr, FUTEX_BITSET_MATCH_ANY);
+    }
+    _waiters.fetch_sub(1, std::memory_order_relaxed);
+    return !(ret < 0 && errno == ETIMEDOUT);
+}
+
+// park until the epoch of any of the event counts differs from its key
+// (may return spuriously, so the caller must check its conditions again)
+inline void EventCount::waitAny(EventCount *const *events, const std::uint32_t *keys, std::size_t num)
+{
+    waitAny(events, keys, num, nullptr);
+}
+
+// park until the epoch of any of the event counts differs from its key
+// or the deadline expires
+// (may return spuriously, so the caller must check its conditions again)
+// returns false if the deadline expired
+inline bool EventCount::waitAnyUntil(EventCount *const *events, const std::uint32_t *keys, std::size_t num,
+                                     const std::chrono::steady_clock::time_point &deadline)
+{
+    struct timespec ts{monotonic(deadline)};
+    return waitAny(events, keys, num, &ts);
+}
+
+// futex timeouts are absolute CLOCK_MONOTONIC times, which is the steady clock
+inline struct timespec EventCount::monotonic(const std::chrono::steady_clock::time_point &deadline)
+{
+    auto ns{std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count()};
+    struct timespec ts{};
+
+    if (ns > 0)
+    {
+        ts.tv_sec = ns / 1000000000;
+        ts.tv_nsec = ns % 1000000000;
+    }
+    return ts;
+}
+
+inline bool EventCount::waitAny(EventCount *const *events, const std::uint32_t *keys, std::size_t num,
+                                const struct timespec *deadline)
+{
+    bool parked{true};
+    bool expired{false};
+
+    for (std::size_t i{0}; i < num; i++)
+    {
+        if (events[i]->_epoch.load(std::memory_order_acquire) != keys[i])
+        {
+            parked = false;
+        }
+    }
+    if (parked && num <= FUTEX_WAITV_MAX)
+    {
+        struct futex_waitv waiters[FUTEX_WAITV_MAX]{};
+        for (std::size_t i{0}; i < num; i++)
+        {
+            waiters[i].val = keys[i];
+            waiters[i].uaddr = reinterpret_cast<std::uintptr_t>(&events[i]->_epoch);
+            waiters[i].flags = FUTEX_32 | events[i]->_private;
+        }
+        long ret{syscall(SYS_futex_waitv, waiters, num, 0, deadline, CLOCK_MONOTONIC)};
+        if (ret >= 0 || errno != ENOSYS)
+        {
+            parked = false;
+            expired = ret < 0 && errno == ETIMEDOUT;
+        }
+    }
+    if (parked)
+    {
+        // futex_waitv is unavailable, so park on the first event count for
+        // at most a millisecond and let the caller check every condition again
+        struct timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        ts.tv_nsec += 1000000;
+        if (ts.tv_nsec >= 1000000000)
+        {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000;
+        }
+        bool last{deadline != nullptr &&
+                  (deadline->tv_sec < ts.tv_sec || (deadline->tv_sec == ts.tv_sec && deadline->tv_nsec <= ts.tv_nsec))};
+        if (last)
+        {
+            ts = *deadline;
+        }
+        long ret{syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&events[0]->_epoch), FUTEX_WAIT_BITSET | events[0]->_private,
+                         keys[0], &ts, nullptr, FUTEX_BITSET_MATCH_ANY)};
+        expired = last && ret < 0 && errno == ETIMEDOUT;
+    }
+    for (std::size_t i{0}; i < num; i++)
+    {
+        events[i]->_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return !expired;
+}
+
+// wake up to num parked waiters
+inline void EventCount::notify(std::size_t num)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_waiters.load(std::memory_order_relaxed) == 0)
+    {
+        return;
+    }
+    _epoch.fetch_add(1, std::memory_order_seq_cst);
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&_epoch), FUTEX_WAKE | _private, num < INT_MAX ? int(num) : INT_MAX, nullptr, nullptr, 0);
+}
+
+inline void EventCount::notifyOne()
+{
+    notify(1);
+}
+
+inline void EventCount::notifyAll()
+{
+    notify(INT_MAX);
+}
+
+// call pred until it returns true, spinning for up to spin attempts before
+// parking between attempts
+template<typename F>
+void EventCount::await(F &&pred, std::size_t spin)
+{
+    for (std::size_t i{0}; i < spin; i++)
+    {
+        if (pred())
+        {
+            return;
+        }
+        pause();
+    }
+    for (;;)
+    {
+        if (pred())
+        {
+            return;
+        }
+        std::uint32_t key{prepareWait()};
+        if (pred())
+        {
+            cancelWait();
+            return;
+        }
+        wait(key);
+    }
+}
+
+// call pred until it returns true or the deadline expires, spinning for up to
+// spin attempts before parking between attempts
+// returns false if the deadline expired
+template<typename F>
+bool EventCount::awaitUntil(F &&pred, std::size_t spin, const std::chrono::steady_clock::time_point &deadline)
+{
+    for (std::size_t i{0}; i < spin; i++)
+    {
+        if (pred())
+        {
+            return true;
+        }
+        pause();
+    }
+    for (;;)
+    {
+        if (pred())
+        {
+            return true;
+        }
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            return false;
+        }
+        std::uint32_t key{prepareWait()};
+        if (pred())
+        {
+            cancelWait();
+            return true;
+        }
+        waitUntil(key, deadline);
+    }
+}
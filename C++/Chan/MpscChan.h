@@ -0,0 +1,62 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#ifndef MPSC_CHAN_H
+#define MPSC_CHAN_H
+
+#include "SpscCircBuf.h"
+#include "EventCount.h"
+#include <memory>
+#include <vector>
+#include <utility>
+#include <chrono>
+#include <cerrno>
+
+namespace Circular
+{
+
+template<typename T, std::size_t N>
+class MpscChan
+{
+    struct Shard
+    {
+        Circular::Moving::SpscCircBuf<T, N> circBuf;
+        EventCount wrEvent;
+    };
+public:
+    static constexpr std::size_t defaultSpin{256};
+    explicit MpscChan(std::size_t numProducers, std::size_t spin = defaultSpin);
+    MpscChan(const MpscChan &) = delete;
+    MpscChan(MpscChan &&) = delete;
+    virtual ~MpscChan() = default;
+    MpscChan &operator=(const MpscChan &) = delete;
+    MpscChan &operator=(MpscChan &&) = delete;
+    std::size_t producers() const;
+    std::size_t spin() const;
+    void spin(std::size_t);
+    std::size_t count() const;
+    std::size_t space(std::size_t) const;
+    std::size_t push(std::size_t, T &&);
+    std::size_t tryPush(std::size_t, T &&);
+    std::size_t pushN(std::size_t, T *, std::size_t);
+    std::size_t pop(T &&);
+    std::size_t tryPop(T &&);
+    std::size_t popUntil(T &&, const std::chrono::steady_clock::time_point &);
+    std::size_t popN(T *, std::size_t);
+protected:
+    std::size_t take(T *, std::size_t);
+    std::vector<std::unique_ptr<Shard>> _shards;
+    EventCount _rdEvent;
+    std::size_t _next{0};
+    std::size_t _spin;
+};
+
+#include "MpscChan.hpp"
+
+}  // namespace Circular
+
+#endif
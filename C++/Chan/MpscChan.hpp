@@ -0,0 +1,184 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+// A queue for many producers and a single consumer, implemented using a
+// separate single producer, single consumer moving circular buffer for each
+// producer, so that producers never contend with each other for an index.
+//
+// Each producer is identified by a number less than the number of producers
+// given to the constructor, and only one thread may push with a given number.
+// Only one thread may pop.
+//
+// The consumer takes items from the circular buffers in turn, starting after
+// the circular buffer that it took from last, so that no producer is starved by
+// another. popN takes a batch of items from one circular buffer after another
+// until the batch is full or every circular buffer has been visited once.
+//
+// A consumer that finds every circular buffer empty parks on a single event
+// count, which every push notifies. A producer that finds its circular buffer
+// full parks on an event count of its own, which the consumer notifies after
+// taking items from that circular buffer. As with Chan, these notifications
+// only make a system call when a thread is actually parked.
+
+template<typename T, std::size_t N>
+MpscChan<T, N>::MpscChan(std::size_t numProducers, std::size_t spin) : _spin{spin}
+{
+    if (numProducers == 0)
+    {
+        throw EINVAL;
+    }
+    for (std::size_t i{0}; i < numProducers; i++)
+    {
+        _shards.emplace_back(new Shard);
+    }
+}
+
+// number of producers
+template<typename T, std::size_t N>
+std::size_t MpscChan<T, N>::producers() const
+{
+    return _shards.size();
+}
+
+// number of attempts made before parking a blocked operation
+template<typename T, std::size_t N>
+std::size_t MpscChan<T, N>::spin() const
+{
+    return _spin;
+}
+
+template<typename T, std::size_t N>
+void MpscChan<T, N>::spin(std::size_t spin)
+{
+    _spin = spin;
+}
+
+// total number of items present in the channel
+template<typename T, std::size_t N>
+std::size_t MpscChan<T, N>::count() const
+{
+    std::size_t num{0};
+
+    for (const auto &shard : _shards)
+    {
+        num += shard->circBuf.count();
+    }
+    return num;
+}
+
+// space available for items from producer p
+template<typename T, std::size_t N>
+std::size_t MpscChan<T, N>::space(std::size_t p) const
+{
+    return _shards[p]->circBuf.space();
+}
+
+// push an item from producer p
+// returns number of items pushed
+template<typename T, std::size_t N>
+std::size_t MpscChan<T, N>::push(std::size_t p, T &&val)
+{
+    Shard &shard{*_shards[p]};
+
+    shard.wrEvent.await([&shard, &val]() {return shard.circBuf.push(std::forward<T>(val)) == 1;}, _spin);
+    _rdEvent.notifyOne();
+    return 1;
+}
+
+// push an item from producer p
+// returns number of items pushed (zero if the circular buffer of producer p is full)
+template<typename T, std::size_t N>
+std::size_t MpscChan<T, N>::tryPush(std::size_t p, T &&val)
+{
+    if (_shards[p]->circBuf.push(std::forward<T>(val)) == 0)
+    {
+        return 0;
+    }
+    _rdEvent.notifyOne();
+    return 1;
+}
+
+// block until at least one slot is available to producer p and then push as
+// many items as possible
+// returns number of items pushed
+template<typename T, std::size_t N>
+std::size_t MpscChan<T, N>::pushN(std::size_t p, T *buf, std::size_t len)
+{
+    Shard &shard{*_shards[p]};
+    std::size_t num{0};
+
+    if (len == 0)
+    {
+        return 0;
+    }
+    shard.wrEvent.await([&shard, buf, len, &num]() {return (num = shard.circBuf.write(buf, len)) > 0;}, _spin);
+    _rdEvent.notifyOne();
+    return num;
+}
+
+// returns number of items popped
+template<typename T, std::size_t N>
+std::size_t MpscChan<T, N>::pop(T &&val)
+{
+    _rdEvent.await([this, &val]() {return take(&val, 1) == 1;}, _spin);
+    return 1;
+}
+
+// returns number of items popped (zero if the channel is empty)
+template<typename T, std::size_t N>
+std::size_t MpscChan<T, N>::tryPop(T &&val)
+{
+    return take(&val, 1);
+}
+
+// returns number of items popped (zero if the deadline expired)
+template<typename T, std::size_t N>
+std::size_t MpscChan<T, N>::popUntil(T &&val, const std::chrono::steady_clock::time_point &deadline)
+{
+    return _rdEvent.awaitUntil([this, &val]() {return take(&val, 1) == 1;}, _spin, deadline) ? 1 : 0;
+}
+
+// block until at least one item is present and then pop as many as possible
+// returns number of items popped
+template<typename T, std::size_t N>
+std::size_t MpscChan<T, N>::popN(T *buf, std::size_t len)
+{
+    std::size_t num{0};
+
+    if (len == 0)
+    {
+        return 0;
+    }
+    _rdEvent.await([this, buf, len, &num]() {return (num = take(buf, len)) > 0;}, _spin);
+    return num;
+}
+
+// read up to len items from the circular buffers in turn, visiting each at most
+// once, and wake the producers whose circular buffers were read
+// returns number of items read
+template<typename T, std::size_t N>
+std::size_t MpscChan<T, N>::take(T *buf, std::size_t len)
+{
+    std::size_t numShards{_shards.size()};
+    std::size_t ret{0};
+
+    for (std::size_t i{0}; i < numShards && ret < len; i++)
+    {
+        Shard &shard{*_shards[_next]};
+        std::size_t num{shard.circBuf.read(buf + ret, len - ret)};
+        if (++_next >= numShards)
+        {
+            _next = 0;
+        }
+        if (num > 0)
+        {
+            shard.wrEvent.notifyOne();
+            ret += num;
+        }
+    }
+    return ret;
+}
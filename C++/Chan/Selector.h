@@ -0,0 +1,63 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#ifndef SELECTOR_H
+#define SELECTOR_H
+
+#include "Chan.h"
+#include "EventCount.h"
+#include <functional>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+namespace Circular
+{
+
+class Selector
+{
+    struct Case
+    {
+        EventCount *event;
+        std::function<bool()> attempt;
+        std::function<bool()> ready;
+    };
+public:
+    static constexpr std::size_t none{SIZE_MAX};
+    static constexpr std::size_t defaultSpin{256};
+    explicit Selector(std::size_t spin = defaultSpin);
+    Selector(const Selector &) = delete;
+    Selector(Selector &&) = delete;
+    virtual ~Selector() = default;
+    Selector &operator=(const Selector &) = delete;
+    Selector &operator=(Selector &&) = delete;
+    std::size_t spin() const;
+    void spin(std::size_t);
+    std::size_t count() const;
+    void clear();
+    template<typename T, std::size_t N>
+    std::size_t pop(Chan<T, N> &, T &);
+    template<typename T, std::size_t N>
+    std::size_t push(Chan<T, N> &, T &);
+    std::size_t trySelect();
+    std::size_t select();
+    std::size_t selectUntil(const std::chrono::steady_clock::time_point &);
+protected:
+    std::size_t park(const std::chrono::steady_clock::time_point *);
+    void passOn(std::size_t);
+    std::vector<Case> _cases;
+    std::vector<EventCount *> _events;
+    std::vector<std::uint32_t> _keys;
+    std::size_t _next{0};
+    std::size_t _spin;
+};
+
+#include "Selector.hpp"
+
+}  // namespace Circular
+
+#endif
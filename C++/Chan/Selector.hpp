@@ -0,0 +1,178 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+// Waits on a set of channels, some to pop from and some to push to, and
+// completes whichever operation becomes possible first, in the same way as a
+// select statement in Go.
+//
+// Each case is registered with pop or push, which return the index of the case.
+// trySelect attempts every case once without blocking. select and selectUntil
+// first retry for up to spin iterations and then register as a waiter on the
+// event count of every case and park on all of them at once, so a ready case
+// never costs a system call.
+//
+// Cases are attempted in turn starting after the case that completed last, so
+// that no ready channel is starved by another.
+//
+// A parked selector may be the one waiter that a channel chooses to wake and
+// then complete a different case. To avoid stranding that wakeup, a selector
+// that has parked passes a notification on to every other case that is ready.
+//
+// A selector must only be used by one thread at a time, and the channels and
+// values registered with it must outlive it or the next call to clear.
+
+inline Selector::Selector(std::size_t spin) : _spin{spin} {}
+
+// number of attempts made before parking
+inline std::size_t Selector::spin() const
+{
+    return _spin;
+}
+
+inline void Selector::spin(std::size_t spin)
+{
+    _spin = spin;
+}
+
+// total number of cases
+inline std::size_t Selector::count() const
+{
+    return _cases.size();
+}
+
+// remove all cases
+inline void Selector::clear()
+{
+    _cases.clear();
+    _next = 0;
+}
+
+// add a case that pops an item from the channel into val
+// returns the index of the case
+template<typename T, std::size_t N>
+std::size_t Selector::pop(Chan<T, N> &chan, T &val)
+{
+    _cases.push_back({&chan._core.rdEvent(),
+                      [&chan, &val]() {return chan.tryPop(std::move(val)) == 1;},
+                      [&chan]() {return chan.count() > 0;}});
+    return _cases.size() - 1;
+}
+
+// add a case that pushes val into the channel
+// (val is only moved from if the case completes)
+// returns the index of the case
+template<typename T, std::size_t N>
+std::size_t Selector::push(Chan<T, N> &chan, T &val)
+{
+    _cases.push_back({&chan._core.wrEvent(),
+                      [&chan, &val]() {return chan.tryPush(std::move(val)) == 1;},
+                      [&chan]() {return chan.space() > 0;}});
+    return _cases.size() - 1;
+}
+
+// returns the index of the case that completed (none if no case is ready)
+inline std::size_t Selector::trySelect()
+{
+    std::size_t num{_cases.size()};
+
+    for (std::size_t i{0}; i < num; i++)
+    {
+        std::size_t j{(_next + i) % num};
+        if (_cases[j].attempt())
+        {
+            _next = j + 1;
+            return j;
+        }
+    }
+    return none;
+}
+
+// block until a case completes
+// returns the index of the case that completed (none if there are no cases)
+inline std::size_t Selector::select()
+{
+    return park(nullptr);
+}
+
+// block until a case completes or the deadline expires
+// returns the index of the case that completed (none if the deadline expired)
+inline std::size_t Selector::selectUntil(const std::chrono::steady_clock::time_point &deadline)
+{
+    return park(&deadline);
+}
+
+inline std::size_t Selector::park(const std::chrono::steady_clock::time_point *deadline)
+{
+    std::size_t num{_cases.size()};
+    std::size_t ret{none};
+    bool parked{false};
+
+    if (num == 0)
+    {
+        return none;
+    }
+    for (std::size_t i{0}; i < _spin; i++)
+    {
+        if ((ret = trySelect()) != none)
+        {
+            return ret;
+        }
+        EventCount::pause();
+    }
+    _events.resize(num);
+    _keys.resize(num);
+    for (;;)
+    {
+        if ((ret = trySelect()) != none)
+        {
+            break;
+        }
+        if (deadline != nullptr && std::chrono::steady_clock::now() >= *deadline)
+        {
+            return none;
+        }
+        for (std::size_t i{0}; i < num; i++)
+        {
+            _events[i] = _cases[i].event;
+            _keys[i] = _events[i]->prepareWait();
+        }
+        if ((ret = trySelect()) != none)
+        {
+            for (std::size_t i{0}; i < num; i++)
+            {
+                _events[i]->cancelWait();
+            }
+            break;
+        }
+        if (deadline != nullptr)
+        {
+            EventCount::waitAnyUntil(_events.data(), _keys.data(), num, *deadline);
+        }
+        else
+        {
+            EventCount::waitAny(_events.data(), _keys.data(), num);
+        }
+        parked = true;
+    }
+    if (parked)
+    {
+        passOn(ret);
+    }
+    return ret;
+}
+
+// notify the waiters of every ready case other than the one that completed
+inline void Selector::passOn(std::size_t done)
+{
+    for (std::size_t i{0}; i < _cases.size(); i++)
+    {
+        if (i != done && _cases[i].ready())
+        {
+            _cases[i].event->notifyOne();
+        }
+    }
+}
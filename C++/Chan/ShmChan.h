@@ -0,0 +1,85 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#ifndef SHM_CHAN_H
+#define SHM_CHAN_H
+
+#include "ChanCore.h"
+#include <atomic>
+#include <string>
+#include <chrono>
+#include <new>
+#include <type_traits>
+#include <cstdint>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace Circular
+{
+
+template<typename T, std::size_t N>
+class ShmChan
+{
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+    static_assert(std::atomic<std::size_t>::is_always_lock_free, "std::atomic<std::size_t> must be lock free");
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "std::atomic<std::uint32_t> must be lock free");
+    struct Header
+    {
+        std::atomic<std::uint32_t> ready;
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t elemLen;
+        std::uint64_t len;
+        std::uint64_t segLen;
+    };
+    struct Shared
+    {
+        Header header;
+        ChanCore<T, N> core{true};
+    };
+    static_assert(std::is_standard_layout_v<Shared>, "the shared state must be standard layout");
+    static_assert(std::is_trivially_destructible_v<Shared>, "the shared state must be trivially destructible");
+public:
+    enum class Mode {create, attach};
+    static constexpr std::uint32_t magic{0x4e414843};  // "CHAN"
+    static constexpr std::uint32_t version{1};
+    static constexpr std::size_t defaultSpin{256};
+    ShmChan(const std::string &, Mode, std::size_t spin = defaultSpin);
+    ShmChan(int, Mode, std::size_t spin = defaultSpin);
+    ShmChan(const ShmChan &) = delete;
+    ShmChan(ShmChan &&) = delete;
+    virtual ~ShmChan();
+    ShmChan &operator=(const ShmChan &) = delete;
+    ShmChan &operator=(ShmChan &&) = delete;
+    static std::size_t segLen();
+    static void unlink(const std::string &);
+    std::size_t spin() const;
+    void spin(std::size_t);
+    std::size_t count() const;
+    std::size_t space() const;
+    std::size_t pop(T &&);
+    std::size_t push(T &&);
+    std::size_t tryPop(T &&);
+    std::size_t tryPush(T &&);
+    std::size_t popUntil(T &&, const std::chrono::steady_clock::time_point &);
+    std::size_t pushUntil(T &&, const std::chrono::steady_clock::time_point &);
+    std::size_t popN(T *, std::size_t);
+    std::size_t pushN(T *, std::size_t);
+protected:
+    void map(int, Mode);
+    Shared *_shared{nullptr};
+    std::size_t _spin;
+};
+
+#include "ShmChan.hpp"
+
+}  // namespace Circular
+
+#endif
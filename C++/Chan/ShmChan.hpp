@@ -0,0 +1,236 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+// A channel between processes whose ChanCore, the multiple producer, multiple
+// consumer circular buffer and the event counts that Chan also uses, is placed
+// in a shared memory segment with its event counts constructed as shared.
+//
+// One process creates the channel and any number of others attach to it, either
+// by the name of a POSIX shared memory object or by a file descriptor such as a
+// memfd that was inherited or passed over a Unix domain socket. A channel given
+// a file descriptor maps it but does not take ownership of it.
+//
+// The segment starts with a header that records a magic number, the version of
+// the layout, the length of an item, the number of items and the length of the
+// segment. The creator fills in the header and sets ready last, and a process
+// attaching to the segment checks all of them, so that channels built from
+// different versions or with different parameters cannot be mixed up. Attaching
+// throws EAGAIN if the creator has not finished yet, in which case the caller may
+// try again, and EINVAL if the header does not match.
+//
+// Items are copied between address spaces, so they must be trivially copyable
+// and must not contain pointers. The shared state is standard layout and has no
+// virtual members or pointers, so nothing else in the segment depends on the
+// process that constructed it or the address that it is mapped at. It is
+// trivially destructible and is never destroyed, since the segment may outlive
+// every process that uses it.
+//
+// The segment outlives the channels mapped onto it, so a named segment must be
+// removed with unlink once every process has attached.
+
+template<typename T, std::size_t N>
+ShmChan<T, N>::ShmChan(const std::string &name, Mode mode, std::size_t spin) : _spin{spin}
+{
+    int flags{mode == Mode::create ? O_RDWR | O_CREAT | O_EXCL : O_RDWR};
+    int fd{shm_open(name.c_str(), flags, S_IRUSR | S_IWUSR)};
+
+    if (fd < 0)
+    {
+        throw errno;
+    }
+    try
+    {
+        map(fd, mode);
+    }
+    catch (...)
+    {
+        close(fd);
+        if (mode == Mode::create)
+        {
+            shm_unlink(name.c_str());
+        }
+        throw;
+    }
+    close(fd);
+}
+
+template<typename T, std::size_t N>
+ShmChan<T, N>::ShmChan(int fd, Mode mode, std::size_t spin) : _spin{spin}
+{
+    map(fd, mode);
+}
+
+template<typename T, std::size_t N>
+ShmChan<T, N>::~ShmChan()
+{
+    munmap(_shared, sizeof(Shared));
+}
+
+// length of the shared memory segment
+template<typename T, std::size_t N>
+std::size_t ShmChan<T, N>::segLen()
+{
+    return sizeof(Shared);
+}
+
+// remove a named shared memory segment
+// (the segment is freed once every process has unmapped it)
+template<typename T, std::size_t N>
+void ShmChan<T, N>::unlink(const std::string &name)
+{
+    if (shm_unlink(name.c_str()) < 0)
+    {
+        throw errno;
+    }
+}
+
+template<typename T, std::size_t N>
+void ShmChan<T, N>::map(int fd, Mode mode)
+{
+    struct stat st{};
+    void *addr{nullptr};
+
+    if (mode == Mode::create)
+    {
+        if (ftruncate(fd, sizeof(Shared)) < 0)
+        {
+            throw errno;
+        }
+    }
+    else
+    {
+        if (fstat(fd, &st) < 0)
+        {
+            throw errno;
+        }
+        if (st.st_size == 0)
+        {
+            throw EAGAIN;
+        }
+        if (std::size_t(st.st_size) != sizeof(Shared))
+        {
+            throw EINVAL;
+        }
+    }
+    addr = mmap(nullptr, sizeof(Shared), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED)
+    {
+        throw errno;
+    }
+    if (mode == Mode::create)
+    {
+        _shared = new (addr) Shared;
+        _shared->header.magic = magic;
+        _shared->header.version = version;
+        _shared->header.elemLen = sizeof(T);
+        _shared->header.len = N;
+        _shared->header.segLen = sizeof(Shared);
+        _shared->header.ready.store(1, std::memory_order_release);
+        return;
+    }
+    Shared *shared{static_cast<Shared *>(addr)};
+    if (shared->header.ready.load(std::memory_order_acquire) == 0)
+    {
+        munmap(addr, sizeof(Shared));
+        throw EAGAIN;
+    }
+    if (shared->header.magic != magic
+     || shared->header.version != version
+     || shared->header.elemLen != sizeof(T)
+     || shared->header.len != N
+     || shared->header.segLen != sizeof(Shared))
+    {
+        munmap(addr, sizeof(Shared));
+        throw EINVAL;
+    }
+    _shared = shared;
+}
+
+// number of attempts made before parking a blocked operation
+template<typename T, std::size_t N>
+std::size_t ShmChan<T, N>::spin() const
+{
+    return _spin;
+}
+
+template<typename T, std::size_t N>
+void ShmChan<T, N>::spin(std::size_t spin)
+{
+    _spin = spin;
+}
+
+// total number of items present in the channel
+template<typename T, std::size_t N>
+std::size_t ShmChan<T, N>::count() const
+{
+    return _shared->core.count();
+}
+
+// total space available for items in the channel
+template<typename T, std::size_t N>
+std::size_t ShmChan<T, N>::space() const
+{
+    return _shared->core.space();
+}
+
+// returns number of items popped
+template<typename T, std::size_t N>
+std::size_t ShmChan<T, N>::pop(T &&val)
+{
+    return _shared->core.pop(std::forward<T>(val), _spin);
+}
+
+// returns number of items pushed
+template<typename T, std::size_t N>
+std::size_t ShmChan<T, N>::push(T &&val)
+{
+    return _shared->core.push(std::forward<T>(val), _spin);
+}
+
+// returns number of items popped (zero if the channel is empty)
+template<typename T, std::size_t N>
+std::size_t ShmChan<T, N>::tryPop(T &&val)
+{
+    return _shared->core.tryPop(std::forward<T>(val));
+}
+
+// returns number of items pushed (zero if the channel is full)
+template<typename T, std::size_t N>
+std::size_t ShmChan<T, N>::tryPush(T &&val)
+{
+    return _shared->core.tryPush(std::forward<T>(val));
+}
+
+// returns number of items popped (zero if the deadline expired)
+template<typename T, std::size_t N>
+std::size_t ShmChan<T, N>::popUntil(T &&val, const std::chrono::steady_clock::time_point &deadline)
+{
+    return _shared->core.popUntil(std::forward<T>(val), _spin, deadline);
+}
+
+// returns number of items pushed (zero if the deadline expired)
+template<typename T, std::size_t N>
+std::size_t ShmChan<T, N>::pushUntil(T &&val, const std::chrono::steady_clock::time_point &deadline)
+{
+    return _shared->core.pushUntil(std::forward<T>(val), _spin, deadline);
+}
+
+// block until at least one item is present and then pop as many as possible
+// returns number of items popped
+template<typename T, std::size_t N>
+std::size_t ShmChan<T, N>::popN(T *buf, std::size_t len)
+{
+    return _shared->core.popN(buf, len, _spin);
+}
+
+// block until at least one slot is available and then push as many as possible
+// returns number of items pushed
+template<typename T, std::size_t N>
+std::size_t ShmChan<T, N>::pushN(T *buf, std::size_t len)
+{
+    return _shared->core.pushN(buf, len, _spin);
+}
@@ -0,0 +1,62 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#ifndef WAIT_LIST_H
+#define WAIT_LIST_H
+
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+
+namespace Circular
+{
+
+class WaitList
+{
+public:
+    class Waiter
+    {
+        friend class WaitList;
+    public:
+        Waiter() = default;
+        Waiter(const Waiter &) = delete;
+        Waiter(Waiter &&) = delete;
+        virtual ~Waiter() = default;
+        Waiter &operator=(const Waiter &) = delete;
+        Waiter &operator=(Waiter &&) = delete;
+        virtual void wake() = 0;
+    protected:
+        bool commit();
+    private:
+        enum State : std::uint8_t {idle, parking, parked, notified};
+        Waiter *_prev{nullptr};
+        Waiter *_next{nullptr};
+        bool _listed{false};
+        std::atomic<State> _state{idle};
+    };
+    WaitList() = default;
+    WaitList(const WaitList &) = delete;
+    WaitList(WaitList &&) = delete;
+    virtual ~WaitList() = default;
+    WaitList &operator=(const WaitList &) = delete;
+    WaitList &operator=(WaitList &&) = delete;
+    std::size_t waiters() const;
+    void add(Waiter *);
+    bool remove(Waiter *);
+    void notify(std::size_t);
+protected:
+    alignas(64) std::atomic<std::size_t> _waiters{0};
+    std::mutex _mutex;
+    Waiter *_head{nullptr};
+    Waiter *_tail{nullptr};
+};
+
+#include "WaitList.hpp"
+
+}  // namespace Circular
+
+#endif
@@ -0,0 +1,140 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+// A first in, first out list of waiters that are not threads, such as
+// suspended coroutines, which a notifier wakes by calling their wake function
+// instead of with a futex.
+//
+// A waiter registers by calling add, then checks its condition again and
+// either calls remove (the condition became true) or calls commit (the
+// condition is still false). If remove fails then a notifier has already taken
+// the waiter off the list, and the waiter must call commit.
+//
+// A notifier first makes the condition true and then calls notify, which only
+// takes the lock when at least one waiter is registered, so notifying a list
+// that nobody waits on costs a fence and a load. A notified waiter that has
+// committed is woken by a call to its wake function, which may resume it at
+// once on another thread. A waiter that is notified before it commits is not
+// woken, and instead commit returns false, so a waiter is never destroyed
+// while it is still checking its condition.
+//
+// The sequentially consistent fences in add and notify guarantee that either
+// the waiter sees the condition become true when it checks again or the
+// notifier sees the registered waiter.
+
+// finish parking a waiter that has been added to a list
+// (the waiter may be woken as soon as commit returns true, so the caller must
+// not touch it again)
+// returns false if the waiter was notified first, in which case it is not woken
+inline bool WaitList::Waiter::commit()
+{
+    return _state.exchange(parked, std::memory_order_acq_rel) != notified;
+}
+
+// number of registered waiters
+inline std::size_t WaitList::waiters() const
+{
+    return _waiters.load(std::memory_order_relaxed);
+}
+
+// append a waiter to the list
+inline void WaitList::add(Waiter *waiter)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        waiter->_prev = _tail;
+        waiter->_next = nullptr;
+        waiter->_listed = true;
+        waiter->_state.store(Waiter::parking, std::memory_order_relaxed);
+        if (_tail != nullptr)
+        {
+            _tail->_next = waiter;
+        }
+        else
+        {
+            _head = waiter;
+        }
+        _tail = waiter;
+        _waiters.fetch_add(1, std::memory_order_seq_cst);
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+// take a waiter off the list
+// returns false if a notifier has already taken it off the list
+inline bool WaitList::remove(Waiter *waiter)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!waiter->_listed)
+    {
+        return false;
+    }
+    if (waiter->_prev != nullptr)
+    {
+        waiter->_prev->_next = waiter->_next;
+    }
+    else
+    {
+        _head = waiter->_next;
+    }
+    if (waiter->_next != nullptr)
+    {
+        waiter->_next->_prev = waiter->_prev;
+    }
+    else
+    {
+        _tail = waiter->_prev;
+    }
+    waiter->_listed = false;
+    _waiters.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+// wake up to num waiters in the order that they were added
+inline void WaitList::notify(std::size_t num)
+{
+    Waiter *first{nullptr};
+    Waiter *waiter{nullptr};
+    std::size_t taken{0};
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (num == 0 || _waiters.load(std::memory_order_relaxed) == 0)
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        first = _head;
+        for (waiter = _head; waiter != nullptr && taken < num; waiter = waiter->_next)
+        {
+            waiter->_listed = false;
+            taken++;
+        }
+        // waiter is now the first one left on the list
+        _head = waiter;
+        if (waiter != nullptr)
+        {
+            waiter->_prev->_next = nullptr;
+            waiter->_prev = nullptr;
+        }
+        else
+        {
+            _tail = nullptr;
+        }
+        _waiters.fetch_sub(taken, std::memory_order_relaxed);
+    }
+    while (first != nullptr)
+    {
+        waiter = first;
+        first = first->_next;
+        if (waiter->_state.exchange(Waiter::notified, std::memory_order_acq_rel) == Waiter::parked)
+        {
+            waiter->wake();
+        }
+    }
+}
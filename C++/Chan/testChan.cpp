@@ -10,6 +10,10 @@
 #include <thread>
 #include <chrono>
 #include <utility>
+#include <vector>
+#include <atomic>
+#include <poll.h>
+#include <unistd.h>
 
 using namespace Circular;
 
@@ -62,6 +66,298 @@ TEST(testChan, multithreaded)
     t1.join();
 }
 
+TEST(testChan, multiProducerMultiConsumer)
+{
+    constexpr std::size_t numProducer{8};
+    constexpr std::size_t numConsumer{4};
+    constexpr std::size_t numElem{10000};
+    Chan<Elem, circBufLen> chan;
+    std::vector<std::atomic<std::size_t>> seen(numProducer * numElem);
+    std::vector<std::thread> threads;
+
+    for (std::size_t p{0}; p < numProducer; p++)
+    {
+        threads.emplace_back([&chan, p]()
+                              {
+                                  for (std::size_t i{0}; i < numElem; i++)
+                                  {
+                                      Elem val{p * numElem + i};
+                                      std::size_t num{chan.push(std::move(val))};
+                                      ASSERT_EQ(num, 1);
+                                  }
+                              });
+    }
+    for (std::size_t c{0}; c < numConsumer; c++)
+    {
+        threads.emplace_back([&chan, &seen]()
+                              {
+                                  for (std::size_t i{0}; i < numProducer * numElem / numConsumer; i++)
+                                  {
+                                      Elem val{0};
+                                      std::size_t num{chan.pop(std::move(val))};
+                                      ASSERT_EQ(num, 1);
+                                      seen.at(val.i)++;
+                                  }
+                              });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    for (std::size_t i{0}; i < seen.size(); i++)
+    {
+        ASSERT_EQ(seen.at(i).load(), 1);
+    }
+    ASSERT_EQ(chan.count(), 0);
+}
+
+TEST(testChan, spin)
+{
+    constexpr std::size_t numElem{100000};
+
+    // spin of zero parks as soon as the channel is empty or full
+    for (std::size_t spin : {std::size_t(0), Chan<Elem, circBufLen>::defaultSpin})
+    {
+        Chan<Elem, circBufLen> chan(spin);
+        ASSERT_EQ(chan.spin(), spin);
+
+        std::thread t1([&chan]()
+                        {
+                            for (std::size_t i{1}; i <= numElem; i++)
+                            {
+                                Elem val{0};
+                                std::size_t num{chan.pop(std::move(val))};
+                                ASSERT_EQ(num, 1);
+                                ASSERT_EQ(val.i, i);
+                            }
+                        });
+        std::thread t2([&chan]()
+                        {
+                            for (std::size_t i{1}; i <= numElem; i++)
+                            {
+                                Elem val{i};
+                                std::size_t num{chan.push(std::move(val))};
+                                ASSERT_EQ(num, 1);
+                            }
+                        });
+        t2.join();
+        t1.join();
+        ASSERT_EQ(chan.count(), 0);
+    }
+}
+
+TEST(testChan, pushNPopN)
+{
+    constexpr std::size_t numProducer{4};
+    constexpr std::size_t numElem{10000};
+    constexpr std::size_t chunkLen{5};
+    Chan<Elem, circBufLen> chan;
+    std::vector<std::atomic<std::size_t>> seen(numProducer * numElem);
+    std::vector<std::thread> threads;
+
+    for (std::size_t p{0}; p < numProducer; p++)
+    {
+        threads.emplace_back([&chan, p]()
+                              {
+                                  std::size_t i{0};
+                                  while (i < numElem)
+                                  {
+                                      Elem buf[chunkLen];
+                                      std::size_t len{numElem - i < chunkLen ? numElem - i : chunkLen};
+                                      for (std::size_t j{0}; j < len; j++)
+                                      {
+                                          buf[j].i = p * numElem + i + j;
+                                      }
+                                      // push the remainder if only part of the chunk fits
+                                      std::size_t j{0};
+                                      while (j < len)
+                                      {
+                                          std::size_t num{chan.pushN(buf + j, len - j)};
+                                          ASSERT_GT(num, 0);
+                                          j += num;
+                                      }
+                                      i += len;
+                                  }
+                              });
+    }
+    threads.emplace_back([&chan, &seen]()
+                          {
+                              std::size_t i{0};
+                              while (i < numProducer * numElem)
+                              {
+                                  Elem buf[circBufLen];
+                                  std::size_t num{(i & 1) ? chan.popN(buf, circBufLen) : chan.popAll(buf, circBufLen)};
+                                  ASSERT_GT(num, 0);
+                                  ASSERT_LE(num, circBufLen);
+                                  for (std::size_t j{0}; j < num; j++)
+                                  {
+                                      seen.at(buf[j].i)++;
+                                  }
+                                  i += num;
+                              }
+                          });
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    for (std::size_t i{0}; i < seen.size(); i++)
+    {
+        ASSERT_EQ(seen.at(i).load(), 1);
+    }
+    ASSERT_EQ(chan.count(), 0);
+}
+
+TEST(testChan, popAll)
+{
+    Chan<Elem, circBufLen> chan;
+
+    // fill the channel so that the data wraps and check that popAll drains it
+    for (std::size_t i{0}; i < circBufLen / 2; i++)
+    {
+        Elem val{i};
+        chan.push(std::move(val));
+    }
+    Elem buf[circBufLen];
+    ASSERT_EQ(chan.popN(buf, circBufLen), circBufLen / 2);
+    for (std::size_t i{1}; i <= circBufLen; i++)
+    {
+        Elem val{i};
+        chan.push(std::move(val));
+    }
+    ASSERT_EQ(chan.popAll(buf, circBufLen - 1), circBufLen - 1);
+    for (std::size_t i{0}; i < circBufLen - 1; i++)
+    {
+        ASSERT_EQ(buf[i].i, i + 1);
+    }
+    ASSERT_EQ(chan.popAll(buf, circBufLen), 1);
+    ASSERT_EQ(buf[0].i, circBufLen);
+}
+
+TEST(testChan, tryPushTryPop)
+{
+    Chan<Elem, circBufLen> chan;
+
+    Elem val{0};
+    ASSERT_EQ(chan.tryPop(std::move(val)), 0);
+    for (std::size_t i{1}; i <= circBufLen; i++)
+    {
+        Elem val{i};
+        ASSERT_EQ(chan.tryPush(std::move(val)), 1);
+    }
+    Elem extra{circBufLen + 1};
+    ASSERT_EQ(chan.tryPush(std::move(extra)), 0);
+    ASSERT_EQ(extra.i, circBufLen + 1);
+    for (std::size_t i{1}; i <= circBufLen; i++)
+    {
+        Elem val{0};
+        ASSERT_EQ(chan.tryPop(std::move(val)), 1);
+        ASSERT_EQ(val.i, i);
+    }
+    ASSERT_EQ(chan.tryPop(std::move(val)), 0);
+}
+
+TEST(testChan, popUntilPushUntil)
+{
+    constexpr auto timeout{std::chrono::milliseconds(sleepMsec)};
+    Chan<Elem, circBufLen> chan;
+
+    // empty channel
+    auto start{std::chrono::steady_clock::now()};
+    Elem val{0};
+    ASSERT_EQ(chan.popUntil(std::move(val), start + timeout), 0);
+    ASSERT_GE(std::chrono::steady_clock::now() - start, timeout);
+
+    // full channel
+    for (std::size_t i{1}; i <= circBufLen; i++)
+    {
+        Elem val{i};
+        ASSERT_EQ(chan.pushUntil(std::move(val), std::chrono::steady_clock::now() + timeout), 1);
+    }
+    start = std::chrono::steady_clock::now();
+    Elem extra{circBufLen + 1};
+    ASSERT_EQ(chan.pushUntil(std::move(extra), start + timeout), 0);
+    ASSERT_GE(std::chrono::steady_clock::now() - start, timeout);
+
+    // a deadline in the past still succeeds if the operation can complete immediately
+    ASSERT_EQ(chan.popUntil(std::move(val), start), 1);
+    ASSERT_EQ(val.i, 1);
+
+    // a parked operation completes when the other side makes progress
+    std::thread t([&chan]()
+                   {
+                       std::this_thread::sleep_for(std::chrono::milliseconds(sleepMsec));
+                       Elem val{0};
+                       ASSERT_EQ(chan.pop(std::move(val)), 1);
+                       ASSERT_EQ(val.i, 2);
+                   });
+    Elem next1{circBufLen + 1};
+    ASSERT_EQ(chan.pushUntil(std::move(next1), std::chrono::steady_clock::now() + 100 * timeout), 1);
+    Elem next2{circBufLen + 2};
+    ASSERT_EQ(chan.pushUntil(std::move(next2), std::chrono::steady_clock::now() + 100 * timeout), 1);
+    t.join();
+    ASSERT_EQ(chan.count(), circBufLen);
+}
+
+TEST(testChan, pollFd)
+{
+    constexpr std::size_t numElem{100};
+    Chan<Elem, circBufLen> chan;
+    ASSERT_EQ(chan.pollFd(), -1);
+
+    Chan<Elem, circBufLen> pollChan(Chan<Elem, circBufLen>::defaultSpin, true);
+    int fd{pollChan.pollFd()};
+    ASSERT_GE(fd, 0);
+    struct pollfd pfd{.fd = fd, .events = POLLIN, .revents = 0};
+    ASSERT_EQ(poll(&pfd, 1, 0), 0);
+
+    // a burst of pushes is signalled once
+    Elem buf[circBufLen / 2];
+    for (std::size_t i{0}; i < circBufLen / 2; i++)
+    {
+        buf[i].i = i;
+    }
+    ASSERT_EQ(pollChan.pushN(buf, circBufLen / 2), circBufLen / 2);
+    for (std::size_t i{circBufLen / 2}; i < circBufLen; i++)
+    {
+        Elem val{i};
+        ASSERT_EQ(pollChan.push(std::move(val)), 1);
+    }
+    ASSERT_EQ(poll(&pfd, 1, 0), 1);
+    std::uint64_t sig{0};
+    ASSERT_EQ(read(fd, &sig, sizeof(sig)), sizeof(sig));
+    ASSERT_EQ(sig, 1);
+
+    // cleared until the next push
+    pollChan.pollClear();
+    ASSERT_EQ(poll(&pfd, 1, 0), 0);
+    Elem val{0};
+    while (pollChan.tryPop(std::move(val)) == 1)
+    {
+    }
+    ASSERT_EQ(poll(&pfd, 1, 0), 0);
+
+    // a consumer driven only by the eventfd sees every item
+    std::thread t([&pollChan]()
+                   {
+                       for (std::size_t i{1}; i <= numElem; i++)
+                       {
+                           Elem val{i};
+                           ASSERT_EQ(pollChan.push(std::move(val)), 1);
+                       }
+                   });
+    std::size_t next{1};
+    while (next <= numElem)
+    {
+        ASSERT_EQ(poll(&pfd, 1, -1), 1);
+        pollChan.pollClear();
+        while (pollChan.tryPop(std::move(val)) == 1)
+        {
+            ASSERT_EQ(val.i, next++);
+        }
+    }
+    t.join();
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,209 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#include "ChanAwait.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <utility>
+
+using namespace Circular;
+
+constexpr std::size_t circBufLen{8};
+
+// runs submitted functions when asked to
+class RunQueue
+{
+public:
+    void submit(std::function<void()> func)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _funcs.push_back(std::move(func));
+    }
+    std::size_t count()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _funcs.size();
+    }
+    // returns number of functions run
+    std::size_t runOne()
+    {
+        std::function<void()> func;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_funcs.empty())
+            {
+                return 0;
+            }
+            func = std::move(_funcs.front());
+            _funcs.pop_front();
+        }
+        func();
+        return 1;
+    }
+private:
+    std::mutex _mutex;
+    std::deque<std::function<void()>> _funcs;
+};
+
+// a coroutine that starts at once and is never awaited
+struct Task
+{
+    struct promise_type
+    {
+        Task get_return_object() {return {};}
+        std::suspend_never initial_suspend() noexcept {return {};}
+        std::suspend_never final_suspend() noexcept {return {};}
+        void return_void() {}
+        void unhandled_exception() {std::terminate();}
+    };
+};
+
+Task consume(Chan<int, circBufLen> &chan, RunQueue &exec, std::size_t num, std::atomic<std::size_t> &sum, std::atomic<std::size_t> &done)
+{
+    for (std::size_t i{0}; i < num; i++)
+    {
+        sum += co_await popAsync(chan, exec);
+    }
+    done++;
+}
+
+Task produce(Chan<int, circBufLen> &chan, RunQueue &exec, std::size_t num, std::atomic<std::size_t> &done)
+{
+    for (std::size_t i{0}; i < num; i++)
+    {
+        co_await pushAsync(chan, int(i), exec);
+    }
+    done++;
+}
+
+TEST(testChanAwait, ready)
+{
+    Chan<int, circBufLen> chan;
+    RunQueue exec;
+    std::atomic<std::size_t> sum{0};
+    std::atomic<std::size_t> done{0};
+
+    ASSERT_EQ(chan.push(1), 1);
+    ASSERT_EQ(chan.push(2), 1);
+    consume(chan, exec, 2, sum, done);
+    ASSERT_EQ(done.load(), 1);
+    ASSERT_EQ(sum.load(), 3);
+    ASSERT_EQ(exec.count(), 0);
+
+    produce(chan, exec, circBufLen, done);
+    ASSERT_EQ(done.load(), 2);
+    ASSERT_EQ(chan.count(), circBufLen);
+    ASSERT_EQ(exec.count(), 0);
+}
+
+TEST(testChanAwait, suspendPop)
+{
+    Chan<int, circBufLen> chan;
+    RunQueue exec;
+    std::atomic<std::size_t> sum{0};
+    std::atomic<std::size_t> done{0};
+
+    consume(chan, exec, 1, sum, done);
+    ASSERT_EQ(done.load(), 0);
+    ASSERT_EQ(exec.count(), 0);
+
+    ASSERT_EQ(chan.push(42), 1);
+    ASSERT_EQ(done.load(), 0);
+    ASSERT_EQ(exec.runOne(), 1);
+    ASSERT_EQ(done.load(), 1);
+    ASSERT_EQ(sum.load(), 42);
+    ASSERT_EQ(chan.count(), 0);
+}
+
+TEST(testChanAwait, suspendPush)
+{
+    Chan<int, circBufLen> chan;
+    RunQueue exec;
+    std::atomic<std::size_t> done{0};
+    int val{0};
+
+    produce(chan, exec, circBufLen + 1, done);
+    ASSERT_EQ(done.load(), 0);
+    ASSERT_EQ(chan.count(), circBufLen);
+
+    ASSERT_EQ(chan.pop(std::move(val)), 1);
+    ASSERT_EQ(val, 0);
+    ASSERT_EQ(exec.runOne(), 1);
+    ASSERT_EQ(done.load(), 1);
+    ASSERT_EQ(chan.count(), circBufLen);
+}
+
+TEST(testChanAwait, stolen)
+{
+    Chan<int, circBufLen> chan;
+    RunQueue exec;
+    std::atomic<std::size_t> sum{0};
+    std::atomic<std::size_t> done{0};
+    int val{0};
+
+    // a thread pops the item before the retry runs, so the coroutine waits again
+    consume(chan, exec, 1, sum, done);
+    ASSERT_EQ(chan.push(1), 1);
+    ASSERT_EQ(chan.tryPop(std::move(val)), 1);
+    ASSERT_EQ(exec.runOne(), 1);
+    ASSERT_EQ(done.load(), 0);
+
+    ASSERT_EQ(chan.push(2), 1);
+    ASSERT_EQ(exec.runOne(), 1);
+    ASSERT_EQ(done.load(), 1);
+    ASSERT_EQ(sum.load(), 2);
+}
+
+TEST(testChanAwait, multithreaded)
+{
+    constexpr std::size_t numCoro{8};
+    constexpr std::size_t numThread{2};
+    constexpr std::size_t numElem{10000};
+    constexpr std::size_t expected{numCoro * numElem * (numElem - 1) / 2};
+    Chan<int, circBufLen> chan;
+    RunQueue exec;
+    std::atomic<std::size_t> sum{0};
+    std::atomic<std::size_t> done{0};
+    std::vector<std::thread> threads;
+
+    for (std::size_t i{0}; i < numCoro; i++)
+    {
+        consume(chan, exec, numElem, sum, done);
+        produce(chan, exec, numElem, done);
+    }
+    for (std::size_t i{0}; i < numThread; i++)
+    {
+        threads.emplace_back([&exec, &done]()
+                             {
+                                 while (done.load() < 2 * numCoro)
+                                 {
+                                     if (exec.runOne() == 0)
+                                     {
+                                         std::this_thread::yield();
+                                     }
+                                 }
+                             });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    ASSERT_EQ(sum.load(), expected);
+    ASSERT_EQ(chan.count(), 0);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
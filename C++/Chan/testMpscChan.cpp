@@ -0,0 +1,169 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#include "MpscChan.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+using namespace Circular;
+
+constexpr std::size_t circBufLen{8};
+constexpr std::size_t sleepMsec{10};
+
+// an item records the producer that pushed it
+typedef std::pair<std::size_t, std::size_t> Elem;
+
+TEST(testMpscChan, invalid)
+{
+    ASSERT_THROW((MpscChan<int, circBufLen>(0)), int);
+}
+
+TEST(testMpscChan, pushPop)
+{
+    MpscChan<int, circBufLen> chan(2);
+    int val{0};
+
+    ASSERT_EQ(chan.producers(), 2);
+    ASSERT_EQ(chan.tryPop(std::move(val)), 0);
+    // each producer has a circular buffer of its own
+    for (std::size_t i{0}; i < circBufLen - 1; i++)
+    {
+        ASSERT_EQ(chan.tryPush(0, int(i)), 1);
+    }
+    ASSERT_EQ(chan.tryPush(0, 99), 0);
+    ASSERT_EQ(chan.space(0), 0);
+    ASSERT_EQ(chan.space(1), circBufLen - 1);
+    ASSERT_EQ(chan.push(1, 100), 1);
+    ASSERT_EQ(chan.count(), circBufLen);
+    for (std::size_t i{0}; i < circBufLen; i++)
+    {
+        ASSERT_EQ(chan.pop(std::move(val)), 1);
+    }
+    ASSERT_EQ(chan.count(), 0);
+}
+
+TEST(testMpscChan, fair)
+{
+    constexpr std::size_t numProducers{3};
+    MpscChan<Elem, circBufLen> chan(numProducers);
+
+    for (std::size_t p{0}; p < numProducers; p++)
+    {
+        for (std::size_t i{0}; i < circBufLen - 1; i++)
+        {
+            ASSERT_EQ(chan.tryPush(p, Elem(p, i)), 1);
+        }
+    }
+    // the consumer takes from each producer in turn
+    for (std::size_t i{0}; i < circBufLen - 1; i++)
+    {
+        for (std::size_t p{0}; p < numProducers; p++)
+        {
+            Elem val{};
+            ASSERT_EQ(chan.tryPop(std::move(val)), 1);
+            ASSERT_EQ(val.first, p);
+            ASSERT_EQ(val.second, i);
+        }
+    }
+}
+
+TEST(testMpscChan, popN)
+{
+    constexpr std::size_t numProducers{2};
+    MpscChan<Elem, circBufLen> chan(numProducers);
+    Elem buf[2 * circBufLen]{};
+
+    for (std::size_t p{0}; p < numProducers; p++)
+    {
+        for (std::size_t i{0}; i < 3; i++)
+        {
+            ASSERT_EQ(chan.tryPush(p, Elem(p, i)), 1);
+        }
+    }
+    // a batch visits every producer
+    ASSERT_EQ(chan.popN(buf, 2 * circBufLen), 6);
+    for (std::size_t i{0}; i < 6; i++)
+    {
+        ASSERT_EQ(buf[i].first, i / 3);
+        ASSERT_EQ(buf[i].second, i % 3);
+    }
+    for (std::size_t i{0}; i < 4; i++)
+    {
+        buf[i] = Elem(1, i);
+    }
+    ASSERT_EQ(chan.pushN(1, buf, 4), 4);
+    ASSERT_EQ(chan.popN(buf, 2), 2);
+    ASSERT_EQ(chan.count(), 2);
+}
+
+TEST(testMpscChan, popUntil)
+{
+    constexpr auto timeout{std::chrono::milliseconds(sleepMsec)};
+    MpscChan<int, circBufLen> chan(2, 0);
+    int val{0};
+
+    auto start{std::chrono::steady_clock::now()};
+    ASSERT_EQ(chan.popUntil(std::move(val), start + timeout), 0);
+    ASSERT_GE(std::chrono::steady_clock::now() - start, timeout);
+
+    std::thread t([&chan]()
+                  {
+                      std::this_thread::sleep_for(std::chrono::milliseconds(sleepMsec));
+                      ASSERT_EQ(chan.push(1, 42), 1);
+                  });
+    ASSERT_EQ(chan.popUntil(std::move(val), std::chrono::steady_clock::now() + 100 * timeout), 1);
+    ASSERT_EQ(val, 42);
+    t.join();
+}
+
+TEST(testMpscChan, multithreaded)
+{
+    constexpr std::size_t numProducers{4};
+    constexpr std::size_t numElem{100000};
+    constexpr std::size_t batchLen{16};
+    MpscChan<Elem, circBufLen> chan(numProducers);
+    std::vector<std::thread> producers;
+    std::vector<std::size_t> next(numProducers, 0);
+
+    for (std::size_t p{0}; p < numProducers; p++)
+    {
+        producers.emplace_back([&chan, p]()
+                               {
+                                   for (std::size_t i{0}; i < numElem; i++)
+                                   {
+                                       ASSERT_EQ(chan.push(p, Elem(p, i)), 1);
+                                   }
+                               });
+    }
+    // the items from each producer arrive in order
+    std::size_t total{0};
+    while (total < numProducers * numElem)
+    {
+        Elem buf[batchLen]{};
+        std::size_t num{chan.popN(buf, batchLen)};
+        ASSERT_GT(num, 0);
+        for (std::size_t i{0}; i < num; i++)
+        {
+            ASSERT_EQ(buf[i].second, next[buf[i].first]++);
+        }
+        total += num;
+    }
+    for (auto &t : producers)
+    {
+        t.join();
+    }
+    ASSERT_EQ(chan.count(), 0);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,189 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#include "Selector.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <chrono>
+#include <utility>
+#include <vector>
+#include <string>
+#include <atomic>
+
+using namespace Circular;
+
+constexpr std::size_t circBufLen{8};
+constexpr std::size_t sleepMsec{10};
+
+TEST(testSelector, trySelect)
+{
+    Chan<int, circBufLen> chan1;
+    Chan<std::string, circBufLen> chan2;
+    Selector sel;
+    int val1{0};
+    std::string val2;
+
+    ASSERT_EQ(sel.trySelect(), Selector::none);
+    ASSERT_EQ(sel.pop(chan1, val1), 0);
+    ASSERT_EQ(sel.pop(chan2, val2), 1);
+    ASSERT_EQ(sel.count(), 2);
+    ASSERT_EQ(sel.trySelect(), Selector::none);
+
+    ASSERT_EQ(chan2.push(std::string("two")), 1);
+    ASSERT_EQ(sel.trySelect(), 1);
+    ASSERT_EQ(val2, "two");
+    ASSERT_EQ(sel.trySelect(), Selector::none);
+
+    sel.clear();
+    ASSERT_EQ(sel.count(), 0);
+}
+
+TEST(testSelector, push)
+{
+    Chan<int, circBufLen> full;
+    Chan<int, circBufLen> empty;
+    Selector sel;
+    int val1{1};
+    int val2{2};
+
+    for (std::size_t i{0}; i < circBufLen; i++)
+    {
+        ASSERT_EQ(full.push(int(i)), 1);
+    }
+    sel.push(full, val1);
+    sel.push(empty, val2);
+    ASSERT_EQ(sel.select(), 1);
+    ASSERT_EQ(empty.count(), 1);
+    ASSERT_EQ(full.count(), circBufLen);
+}
+
+TEST(testSelector, fair)
+{
+    constexpr std::size_t numIter{64};
+    Chan<int, circBufLen> chan1;
+    Chan<int, circBufLen> chan2;
+    Selector sel;
+    int val{0};
+    std::size_t num[2]{0, 0};
+
+    sel.pop(chan1, val);
+    sel.pop(chan2, val);
+    for (std::size_t i{0}; i < numIter; i++)
+    {
+        // keep both channels ready
+        while (chan1.tryPush(1) == 1)
+        {
+        }
+        while (chan2.tryPush(2) == 1)
+        {
+        }
+        std::size_t ret{sel.select()};
+        ASSERT_LT(ret, 2);
+        ASSERT_EQ(val, int(ret + 1));
+        num[ret]++;
+    }
+    ASSERT_EQ(num[0], numIter / 2);
+    ASSERT_EQ(num[1], numIter / 2);
+}
+
+TEST(testSelector, selectUntil)
+{
+    constexpr auto timeout{std::chrono::milliseconds(sleepMsec)};
+    Chan<int, circBufLen> chan1;
+    Chan<int, circBufLen> chan2;
+    Selector sel(0);
+    int val1{0};
+    int val2{0};
+
+    sel.pop(chan1, val1);
+    sel.pop(chan2, val2);
+    auto start{std::chrono::steady_clock::now()};
+    ASSERT_EQ(sel.selectUntil(start + timeout), Selector::none);
+    ASSERT_GE(std::chrono::steady_clock::now() - start, timeout);
+
+    std::thread t([&chan2]()
+                   {
+                       std::this_thread::sleep_for(std::chrono::milliseconds(sleepMsec));
+                       ASSERT_EQ(chan2.push(42), 1);
+                   });
+    ASSERT_EQ(sel.selectUntil(std::chrono::steady_clock::now() + 100 * timeout), 1);
+    ASSERT_EQ(val2, 42);
+    t.join();
+}
+
+TEST(testSelector, multithreaded)
+{
+    constexpr std::size_t numChan{4};
+    constexpr std::size_t numElem{10000};
+    std::vector<Chan<std::size_t, circBufLen>> chans(numChan);
+    std::vector<std::size_t> vals(numChan);
+    std::vector<std::size_t> next(numChan, 0);
+    std::vector<std::thread> threads;
+    Selector sel(0);
+
+    for (std::size_t c{0}; c < numChan; c++)
+    {
+        sel.pop(chans[c], vals[c]);
+        threads.emplace_back([&chans, c]()
+                              {
+                                  for (std::size_t i{0}; i < numElem; i++)
+                                  {
+                                      ASSERT_EQ(chans[c].push(std::size_t(i)), 1);
+                                  }
+                              });
+    }
+    // a competing consumer on one channel must not miss wakeups
+    std::atomic<std::size_t> numPopped0{0};
+    std::thread thief([&chans, &numPopped0]()
+                      {
+                          while (numPopped0.load() < numElem)
+                          {
+                              std::size_t val{0};
+                              auto deadline{std::chrono::steady_clock::now() + std::chrono::milliseconds(sleepMsec)};
+                              if (chans[0].popUntil(std::move(val), deadline) == 1)
+                              {
+                                  numPopped0++;
+                              }
+                          }
+                      });
+    std::size_t total{0};
+    while (total < (numChan - 1) * numElem || numPopped0.load() < numElem)
+    {
+        auto deadline{std::chrono::steady_clock::now() + std::chrono::milliseconds(sleepMsec)};
+        std::size_t ret{sel.selectUntil(deadline)};
+        if (ret == Selector::none)
+        {
+            continue;
+        }
+        ASSERT_LT(ret, numChan);
+        if (ret == 0)
+        {
+            numPopped0++;
+        }
+        else
+        {
+            ASSERT_EQ(vals[ret], next[ret]++);
+            total++;
+        }
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    thief.join();
+    ASSERT_EQ(numPopped0.load(), numElem);
+    for (std::size_t c{1}; c < numChan; c++)
+    {
+        ASSERT_EQ(next[c], numElem);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,141 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#include "ShmChan.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+using namespace Circular;
+
+constexpr std::size_t circBufLen{8};
+constexpr std::size_t sleepMsec{10};
+
+TEST(testShmChan, createAttach)
+{
+    int fd{memfd_create("testShmChan", MFD_CLOEXEC)};
+    int val{0};
+
+    ASSERT_GE(fd, 0);
+    {
+        ShmChan<int, circBufLen> chan1(fd, ShmChan<int, circBufLen>::Mode::create);
+        // a second mapping of the same segment is at a different address
+        ShmChan<int, circBufLen> chan2(fd, ShmChan<int, circBufLen>::Mode::attach);
+
+        ASSERT_EQ(chan1.tryPop(std::move(val)), 0);
+        for (std::size_t i{0}; i < circBufLen; i++)
+        {
+            ASSERT_EQ(chan1.tryPush(int(i)), 1);
+        }
+        ASSERT_EQ(chan1.tryPush(99), 0);
+        ASSERT_EQ(chan2.count(), circBufLen);
+        for (std::size_t i{0}; i < circBufLen; i++)
+        {
+            ASSERT_EQ(chan2.pop(std::move(val)), 1);
+            ASSERT_EQ(val, int(i));
+        }
+        ASSERT_EQ(chan1.space(), circBufLen);
+        auto deadline{std::chrono::steady_clock::now() + std::chrono::milliseconds(sleepMsec)};
+        ASSERT_EQ(chan2.popUntil(std::move(val), deadline), 0);
+    }
+    close(fd);
+}
+
+TEST(testShmChan, mismatch)
+{
+    int fd{memfd_create("testShmChan", MFD_CLOEXEC)};
+
+    ASSERT_GE(fd, 0);
+    // not created yet
+    ASSERT_THROW((ShmChan<int, circBufLen>(fd, ShmChan<int, circBufLen>::Mode::attach)), int);
+    {
+        ShmChan<int, circBufLen> chan(fd, ShmChan<int, circBufLen>::Mode::create);
+        try
+        {
+            ShmChan<int, 2 * circBufLen> other(fd, ShmChan<int, 2 * circBufLen>::Mode::attach);
+            FAIL();
+        }
+        catch (int e)
+        {
+            ASSERT_EQ(e, EINVAL);
+        }
+        try
+        {
+            ShmChan<long long, circBufLen> other(fd, ShmChan<long long, circBufLen>::Mode::attach);
+            FAIL();
+        }
+        catch (int e)
+        {
+            ASSERT_EQ(e, EINVAL);
+        }
+    }
+    close(fd);
+}
+
+TEST(testShmChan, named)
+{
+    std::string name{"/testShmChan." + std::to_string(getpid())};
+    int val{0};
+
+    ShmChan<int, circBufLen> chan1(name, ShmChan<int, circBufLen>::Mode::create);
+    try
+    {
+        ShmChan<int, circBufLen> chan(name, ShmChan<int, circBufLen>::Mode::create);
+        FAIL();
+    }
+    catch (int e)
+    {
+        ASSERT_EQ(e, EEXIST);
+    }
+    ShmChan<int, circBufLen> chan2(name, ShmChan<int, circBufLen>::Mode::attach);
+    ShmChan<int, circBufLen>::unlink(name);
+    ASSERT_THROW((ShmChan<int, circBufLen>(name, ShmChan<int, circBufLen>::Mode::attach)), int);
+    ASSERT_EQ(chan1.push(42), 1);
+    ASSERT_EQ(chan2.pop(std::move(val)), 1);
+    ASSERT_EQ(val, 42);
+}
+
+TEST(testShmChan, multiprocess)
+{
+    constexpr std::size_t numElem{100000};
+    std::string name{"/testShmChan." + std::to_string(getpid())};
+    int status{0};
+
+    ShmChan<std::size_t, circBufLen> chan(name, ShmChan<std::size_t, circBufLen>::Mode::create, 0);
+    pid_t pid{fork()};
+    ASSERT_GE(pid, 0);
+    if (pid == 0)
+    {
+        // the child attaches by name and blocks whenever the channel is full
+        ShmChan<std::size_t, circBufLen> child(name, ShmChan<std::size_t, circBufLen>::Mode::attach, 0);
+        for (std::size_t i{0}; i < numElem; i++)
+        {
+            child.push(std::size_t(i));
+        }
+        _exit(0);
+    }
+    std::size_t val{0};
+    for (std::size_t i{0}; i < numElem; i++)
+    {
+        ASSERT_EQ(chan.pop(std::move(val)), 1);
+        ASSERT_EQ(val, i);
+    }
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+    ShmChan<std::size_t, circBufLen>::unlink(name);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
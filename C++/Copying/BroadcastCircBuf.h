@@ -0,0 +1,75 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#ifndef BROADCAST_CIRC_BUF_H
+#define BROADCAST_CIRC_BUF_H
+
+#include <iostream>
+#include <array>
+#include <atomic>
+#include <algorithm>
+#include <utility>
+
+namespace Circular
+{
+namespace Copying
+{
+
+template<typename T, std::size_t N, std::size_t C>
+class BroadcastCircBuf;
+
+template<typename T, std::size_t N, std::size_t C>
+std::ostream& operator<<(std::ostream&, BroadcastCircBuf<T, N, C>&);
+
+template<typename T, std::size_t N, std::size_t C>
+class BroadcastCircBuf
+{
+    static constexpr bool power_of_2(std::size_t i) {return (i > 0) && ((i & (i - 1)) == 0);}
+    static_assert(power_of_2(N), "N must be an integer power of 2");
+    static_assert(C > 0, "C must be at least 1");
+    static constexpr std::size_t cacheLineLen{64};
+    friend std::ostream& operator<< <T, N, C>(std::ostream&, BroadcastCircBuf&);
+    // written by one consumer
+    struct alignas(cacheLineLen) Cursor
+    {
+        std::atomic<std::size_t> tail{0};
+        std::size_t headCache{0};
+    };
+public:
+    BroadcastCircBuf() = default;
+    BroadcastCircBuf(const BroadcastCircBuf&) = delete;
+    BroadcastCircBuf(BroadcastCircBuf&&) = delete;
+    virtual ~BroadcastCircBuf() = default;
+    BroadcastCircBuf& operator=(const BroadcastCircBuf&) = delete;
+    BroadcastCircBuf& operator=(BroadcastCircBuf&&) = delete;
+    std::size_t len() const;
+    std::size_t consumers() const;
+    std::size_t count() const;
+    std::size_t space() const;
+    std::size_t lag(std::size_t) const;
+    std::size_t push(const T&);
+    std::size_t write(const T*, std::size_t);
+    std::size_t pop(std::size_t, T&);
+    std::size_t read(std::size_t, T*, std::size_t);
+    std::size_t peek(std::size_t, T*, std::size_t);
+    std::size_t consume(std::size_t, std::size_t);
+protected:
+    std::size_t minTail(std::size_t) const;
+    std::size_t available(std::size_t, std::size_t);
+    // written by the producer
+    alignas(cacheLineLen) std::atomic<std::size_t> _head{0};
+    std::size_t _tailCache{0};
+    std::array<Cursor, C> _cursors{};
+    alignas(cacheLineLen) std::array<T, N> _buf{};
+};
+
+#include "BroadcastCircBuf.hpp"
+
+}  // namespace Copying
+}  // namespace Circular
+
+#endif
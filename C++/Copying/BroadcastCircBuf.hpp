@@ -0,0 +1,212 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+// A single producer, multiple consumer queue in which every consumer receives
+// every item, implemented using a contiguous buffer with one atomic index for
+// writing and a separate atomic index, or cursor, for each of C consumers.
+//
+// Elements are copied in to the buffer once and copied out once by each
+// consumer, so broadcasting to C consumers costs a single write instead of C.
+//
+// The head index is the total number of items written. It is only modified by
+// the producer and is published with release ordering after the elements have
+// been copied in, so a consumer that loads it with acquire ordering sees the
+// elements.
+//
+// The tail index of a consumer is the total number of items that it has read.
+// It is only modified by that consumer and is published with release ordering
+// after the elements have been copied out. The producer may only reuse the space
+// that every consumer has read, so it is held back by the slowest consumer.
+//
+// The indices are never wrapped and are reduced modulo N to locate an item, so
+// all N items of the buffer are usable. The head index and each tail index live
+// on separate cache lines. The producer keeps a cached copy of the slowest tail
+// index and each consumer keeps a cached copy of the head index, and these are
+// only reloaded when the cached copy indicates that the buffer is full
+// (producer) or empty (consumer).
+//
+// push and write must only be called by one thread, and pop, read, peek and
+// consume with a given consumer number must only be called by one thread.
+// A consumer number must be less than C.
+
+template<typename T, std::size_t N, std::size_t C>
+std::ostream& operator<<(std::ostream& ostr, BroadcastCircBuf<T, N, C>& cb)
+{
+    std::size_t head{cb._head.load(std::memory_order_acquire)};
+    std::size_t i{cb.minTail(head)};
+
+    ostr << "{";
+    for (; i != head; i++)
+    {
+        ostr << ' ' <<  cb._buf[i & (N - 1)];
+    }
+    ostr << " }";
+    return ostr;
+}
+
+template<typename T, std::size_t N, std::size_t C>
+std::size_t BroadcastCircBuf<T, N, C>::len() const
+{
+    return N;
+}
+
+template<typename T, std::size_t N, std::size_t C>
+std::size_t BroadcastCircBuf<T, N, C>::consumers() const
+{
+    return C;
+}
+
+// total number of items that have not been read by every consumer
+template<typename T, std::size_t N, std::size_t C>
+std::size_t BroadcastCircBuf<T, N, C>::count() const
+{
+    std::size_t head{_head.load(std::memory_order_acquire)};
+
+    return head - minTail(head);
+}
+
+// total space available in the circular buffer
+template<typename T, std::size_t N, std::size_t C>
+std::size_t BroadcastCircBuf<T, N, C>::space() const
+{
+    return N - count();
+}
+
+// number of items that consumer c has not yet read
+template<typename T, std::size_t N, std::size_t C>
+std::size_t BroadcastCircBuf<T, N, C>::lag(std::size_t c) const
+{
+    // load the tail first so that it cannot be ahead of the head
+    std::size_t tail{_cursors[c].tail.load(std::memory_order_acquire)};
+
+    return _head.load(std::memory_order_acquire) - tail;
+}
+
+// returns number of items pushed
+template<typename T, std::size_t N, std::size_t C>
+std::size_t BroadcastCircBuf<T, N, C>::push(const T& val)
+{
+    return write(&val, 1);
+}
+
+// returns number of items written
+template<typename T, std::size_t N, std::size_t C>
+std::size_t BroadcastCircBuf<T, N, C>::write(const T* buf, std::size_t len)
+{
+    std::size_t head{_head.load(std::memory_order_relaxed)};
+    std::size_t num{N - (head - _tailCache)};
+
+    if (num < len)
+    {
+        _tailCache = minTail(head);
+        num = N - (head - _tailCache);
+    }
+    if (len < num)
+    {
+        num = len;
+    }
+    if (num <= 0)
+    {
+        return 0;
+    }
+    std::size_t start{head & (N - 1)};
+    std::size_t first{N - start < num ? N - start : num};
+    std::copy(buf, buf + first, _buf.begin() + start);
+    std::copy(buf + first, buf + num, _buf.begin());
+    _head.store(head + num, std::memory_order_release);
+    return num;
+}
+
+// returns number of items popped
+template<typename T, std::size_t N, std::size_t C>
+std::size_t BroadcastCircBuf<T, N, C>::pop(std::size_t c, T& val)
+{
+    return read(c, &val, 1);
+}
+
+// returns number of items read
+template<typename T, std::size_t N, std::size_t C>
+std::size_t BroadcastCircBuf<T, N, C>::read(std::size_t c, T* buf, std::size_t len)
+{
+    std::size_t num{peek(c, buf, len)};
+
+    if (num > 0)
+    {
+        _cursors[c].tail.store(_cursors[c].tail.load(std::memory_order_relaxed) + num, std::memory_order_release);
+    }
+    return num;
+}
+
+// read data but don't update the tail of consumer c
+// (2 consecutive peek operations with the same arguments will produce the same result
+// provided that the producer has not written more data in between)
+// returns number of items read
+template<typename T, std::size_t N, std::size_t C>
+std::size_t BroadcastCircBuf<T, N, C>::peek(std::size_t c, T* buf, std::size_t len)
+{
+    std::size_t tail{_cursors[c].tail.load(std::memory_order_relaxed)};
+    std::size_t num{available(c, len)};
+
+    if (num <= 0)
+    {
+        return 0;
+    }
+    std::size_t start{tail & (N - 1)};
+    std::size_t first{N - start < num ? N - start : num};
+    std::copy(_buf.begin() + start, _buf.begin() + start + first, buf);
+    std::copy(_buf.begin(), _buf.begin() + (num - first), buf + first);
+    return num;
+}
+
+// returns number of items read
+template<typename T, std::size_t N, std::size_t C>
+std::size_t BroadcastCircBuf<T, N, C>::consume(std::size_t c, std::size_t len)
+{
+    std::size_t num{available(c, len)};
+
+    if (num > 0)
+    {
+        _cursors[c].tail.store(_cursors[c].tail.load(std::memory_order_relaxed) + num, std::memory_order_release);
+    }
+    return num;
+}
+
+// tail index of the slowest consumer
+template<typename T, std::size_t N, std::size_t C>
+std::size_t BroadcastCircBuf<T, N, C>::minTail(std::size_t head) const
+{
+    std::size_t lag{0};
+
+    // compare distances from the head so that the indices may wrap
+    // (a consumer may have read beyond a head loaded by another thread,
+    // which appears as a distance greater than N)
+    for (const auto& cursor : _cursors)
+    {
+        std::size_t dist{head - cursor.tail.load(std::memory_order_acquire)};
+        if (dist <= N && dist > lag)
+        {
+            lag = dist;
+        }
+    }
+    return head - lag;
+}
+
+// returns the number of items, up to len, that consumer c may read
+template<typename T, std::size_t N, std::size_t C>
+std::size_t BroadcastCircBuf<T, N, C>::available(std::size_t c, std::size_t len)
+{
+    Cursor& cursor{_cursors[c]};
+    std::size_t tail{cursor.tail.load(std::memory_order_relaxed)};
+    std::size_t num{cursor.headCache - tail};
+
+    if (num < len)
+    {
+        cursor.headCache = _head.load(std::memory_order_acquire);
+        num = cursor.headCache - tail;
+    }
+    return len < num ? len : num;
+}
@@ -9,38 +9,45 @@
 #define CIRC_BUF_H
 
 #include <iostream>
+#include <algorithm>
 #include <array>
+#include <span>
+#include <utility>
+#include <type_traits>
+#include "HeapArray.h"
 
 namespace Circular
 {
 namespace Copying
 {
 
-template<typename T, std::size_t N>
+template<typename T, std::size_t N, typename S = std::array<T, N>>
 class CircBuf;
 
-template<typename T, std::size_t N>
-std::ostream& operator<<(std::ostream&, CircBuf<T, N>&);
+template<typename T, std::size_t N, typename S>
+std::ostream& operator<<(std::ostream&, CircBuf<T, N, S>&);
 
-template<typename T, std::size_t N>
+template<typename T, std::size_t N, typename S>
 class CircBuf
 {
     static constexpr bool power_of_2(std::size_t i) {return (i > 0) && ((i & (i - 1)) == 0);}
     static_assert(power_of_2(N), "N must be an integer power of 2");
-    friend std::ostream& operator<< <T, N>(std::ostream&, CircBuf&);
+    friend std::ostream& operator<< <T, N, S>(std::ostream&, CircBuf&);
 public:
-    CircBuf() = default;
+    CircBuf();
     CircBuf(const CircBuf&);
+    CircBuf(const CircBuf&, bool);
     CircBuf(CircBuf&&);
     virtual ~CircBuf() = default;
     CircBuf& operator=(const CircBuf&);
     CircBuf& operator=(CircBuf&&);
+    void assign(const CircBuf&, bool);
     std::size_t head() const;
     void head(std::size_t);
     std::size_t tail() const;
     void tail(std::size_t);
     std::size_t len() const;
-    std::array<T, N>& buf();
+    S& buf();
     std::size_t countToEnd(std::size_t) const;
     std::size_t countToEnd() const;
     std::size_t spaceToEnd() const;
@@ -52,12 +59,17 @@ public:
     std::size_t write(const T*, std::size_t);
     std::size_t peek(T*, std::size_t);
     std::size_t consume(std::size_t);
+    std::pair<std::span<const T>, std::span<const T>> readableSpans() const;
 protected:
+    void copyItems(const CircBuf&, bool);
     std::size_t _head{0};
     std::size_t _tail{0};
-    std::array<T, N> _buf{};
+    S _buf;
 };
 
+template<typename T, std::size_t N>
+using HeapCircBuf = CircBuf<T, N, HeapArray<T, N>>;
+
 #include "CircBuf.hpp"
 
 }  // namespace Copying
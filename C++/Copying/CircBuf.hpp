@@ -17,11 +17,25 @@
 //
 // When the head index is equal to the tail index, the circular buffer is empty.
 // When the head index is one less than the tail index, the circular buffer is full.
+//
+// readableSpans lets a consumer inspect items in place instead of copying them
+// out with peek, and then remove the items that it has used with consume.
+//
+// Copying a circular buffer only copies the items present, so its cost depends
+// on the number of items rather than the length of the buffer. The copy either
+// keeps the same indices or, if compacted, starts at index 0 so that the items
+// do not wrap. The slots outside the items are not copied.
+//
+// The items are stored in S, which by default is an array inside the circular
+// buffer, so moving the circular buffer moves every item. HeapCircBuf stores them
+// in a HeapArray instead, so that moving the circular buffer only moves a pointer.
+// A HeapCircBuf that has been moved from has no storage, so its length and space
+// are 0 and nothing can be added to it until it is assigned to.
 
 #include <utility>
 
-template<typename T, std::size_t N>
-std::ostream& operator<<(std::ostream& ostr, CircBuf<T, N>& cb)
+template<typename T, std::size_t N, typename S>
+std::ostream& operator<<(std::ostream& ostr, CircBuf<T, N, S>& cb)
 {
     std::size_t i{cb._tail};
 
@@ -38,70 +52,107 @@ std::ostream& operator<<(std::ostream& ostr, CircBuf<T, N>& cb)
     return ostr;
 }
 
-template<typename T, std::size_t N>
-CircBuf<T, N>::CircBuf(const CircBuf& cb) : _head{cb._head}, _tail{cb._tail}, _buf{cb._buf} {}
+template<typename T, std::size_t N, typename S>
+CircBuf<T, N, S>::CircBuf() : _buf{} {}
+
+template<typename T, std::size_t N, typename S>
+CircBuf<T, N, S>::CircBuf(const CircBuf& cb) : CircBuf(cb, false) {}
+
+// copy the items present, starting at index 0 if compact is true
+// (the rest of the buffer is default initialised, so its value is unspecified)
+template<typename T, std::size_t N, typename S>
+CircBuf<T, N, S>::CircBuf(const CircBuf& cb, bool compact)
+{
+    copyItems(cb, compact);
+}
 
-template<typename T, std::size_t N>
-CircBuf<T, N>::CircBuf(CircBuf&& cb)
+template<typename T, std::size_t N, typename S>
+CircBuf<T, N, S>::CircBuf(CircBuf&& cb) : _head{cb._head}, _tail{cb._tail}, _buf{std::move(cb._buf)}
 {
-    std::swap(_head, cb._head);
-    std::swap(_tail, cb._tail);
-    std::swap(_buf, cb._buf);
+    cb._head = 0;
+    cb._tail = 0;
+    if constexpr (std::is_same_v<S, std::array<T, N>>)
+    {
+        // leave the items as they would be in a new circular buffer
+        cb._buf = S{};
+    }
 }
 
-template<typename T, std::size_t N>
-CircBuf<T, N>& CircBuf<T, N>::operator=(const CircBuf& cb)
+template<typename T, std::size_t N, typename S>
+CircBuf<T, N, S>& CircBuf<T, N, S>::operator=(const CircBuf& cb)
 {
     if (this != &cb)
     {
-        _head = cb._head;
-        _tail = cb._tail;
-        _buf = cb._buf;
+        copyItems(cb, false);
     }
     return *this;
 }
 
-template<typename T, std::size_t N>
-CircBuf<T, N>& CircBuf<T, N>::operator=(CircBuf&& cb)
+template<typename T, std::size_t N, typename S>
+CircBuf<T, N, S>& CircBuf<T, N, S>::operator=(CircBuf&& cb)
 {
-    std::swap(_head, cb._head);
-    std::swap(_tail, cb._tail);
-    std::swap(_buf, cb._buf);
+    if (this == &cb)
+    {
+        return *this;
+    }
+    _head = cb._head;
+    _tail = cb._tail;
+    _buf = std::move(cb._buf);
+    cb._head = 0;
+    cb._tail = 0;
+    if constexpr (std::is_same_v<S, std::array<T, N>>)
+    {
+        // leave the items as they would be in a new circular buffer
+        cb._buf = S{};
+    }
     return *this;
 }
 
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::head() const
+// copy the items present, starting at index 0 if compact is true
+// (the rest of the buffer is left as it was)
+template<typename T, std::size_t N, typename S>
+void CircBuf<T, N, S>::assign(const CircBuf& cb, bool compact)
+{
+    if (this != &cb)
+    {
+        copyItems(cb, compact);
+    }
+}
+
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::head() const
 {
     return _head;
 }
 
-template<typename T, std::size_t N>
-void CircBuf<T, N>::head(std::size_t i)
+template<typename T, std::size_t N, typename S>
+void CircBuf<T, N, S>::head(std::size_t i)
 {
     _head = i;
 }
 
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::tail() const
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::tail() const
 {
     return _tail;
 }
 
-template<typename T, std::size_t N>
-void CircBuf<T, N>::tail(std::size_t i)
+template<typename T, std::size_t N, typename S>
+void CircBuf<T, N, S>::tail(std::size_t i)
 {
     _tail = i;
 }
 
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::len() const
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::len() const
 {
-    return N;
+    return _buf.size();
 }
 
-template<typename T, std::size_t N>
-std::array<T, N>& CircBuf<T, N>::buf()
+// the slots outside the items, from head up to tail, are unspecified in a
+// circular buffer that was copy constructed, as only the items are copied
+template<typename T, std::size_t N, typename S>
+S& CircBuf<T, N, S>::buf()
 {
     return _buf;
 }
@@ -109,8 +160,8 @@ std::array<T, N>& CircBuf<T, N>::buf()
 // number of bytes present up to the end of the linear buffer or
 // the end of the circular buffer, whichever is smaller
 // this special version (with an argument) is required by CircBuf::peek()
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::countToEnd(std::size_t tail) const
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::countToEnd(std::size_t tail) const
 {
     std::size_t countEndLinearBuf{N - tail};
     std::size_t countEndCircBuf{(_head + countEndLinearBuf) & (N - 1)};
@@ -119,39 +170,47 @@ std::size_t CircBuf<T, N>::countToEnd(std::size_t tail) const
 
 // number of bytes present up to the end of the linear buffer or
 // the end of the circular buffer, whichever is smaller
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::countToEnd() const
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::countToEnd() const
 {
     return countToEnd(_tail);
 }
 
 // space available to the end of the linear buffer or
 // the end of the circular buffer, whichever is smaller
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::spaceToEnd() const
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::spaceToEnd() const
 {
+    if (_buf.size() == 0)
+    {
+        return 0;
+    }
     std::size_t spaceEndLinearBuf{N - _head};
     std::size_t spaceEndCircBuf{(_tail + spaceEndLinearBuf - 1) & (N - 1)};
     return spaceEndLinearBuf < spaceEndCircBuf ? spaceEndLinearBuf : spaceEndCircBuf;
 }
 
 // total number of bytes present in the circular buffer
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::count() const
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::count() const
 {
     return (_head - _tail) & (N - 1);
 }
 
 // total space available in the circular buffer
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::space() const
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::space() const
 {
+    if (_buf.size() == 0)
+    {
+        return 0;
+    }
     return (_tail - _head - 1) & (N - 1);
 }
 
 // returns number of items popped
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::pop(T& val)
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::pop(T& val)
 {
     if (count() == 0)
     {
@@ -163,8 +222,8 @@ std::size_t CircBuf<T, N>::pop(T& val)
 }
 
 // returns number of items pushed
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::push(const T& val)
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::push(const T& val)
 {
     if (space() == 0)
     {
@@ -176,8 +235,8 @@ std::size_t CircBuf<T, N>::push(const T& val)
 }
 
 // returns number of items read
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::read(T* buf, std::size_t len)
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::read(T* buf, std::size_t len)
 {
     std::size_t ret{0};
 
@@ -202,8 +261,8 @@ std::size_t CircBuf<T, N>::read(T* buf, std::size_t len)
 }
 
 // returns number of items written
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::write(const T* buf, std::size_t len)
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::write(const T* buf, std::size_t len)
 {
     std::size_t ret{0};
 
@@ -230,8 +289,8 @@ std::size_t CircBuf<T, N>::write(const T* buf, std::size_t len)
 // read data but don't update tail
 // (2 consecutive peek operations with the same arguments will produce the same result)
 // returns number of items read
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::peek(T* buf, std::size_t len)
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::peek(T* buf, std::size_t len)
 {
     std::size_t tail{_tail};
     std::size_t ret{0};
@@ -257,8 +316,8 @@ std::size_t CircBuf<T, N>::peek(T* buf, std::size_t len)
 }
 
 // returns number of items read
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::consume(std::size_t len)
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::consume(std::size_t len)
 {
     std::size_t ret{0};
 
@@ -279,3 +338,37 @@ std::size_t CircBuf<T, N>::consume(std::size_t len)
     }
     return ret;
 }
+
+// items present in the circular buffer, without copying them or updating tail
+// returns the items before and after the end of the linear buffer
+// (the second span is empty unless the items wrap)
+template<typename T, std::size_t N, typename S>
+std::pair<std::span<const T>, std::span<const T>> CircBuf<T, N, S>::readableSpans() const
+{
+    std::size_t first{countToEnd()};
+
+    return {std::span<const T>(_buf.data() + _tail, first), std::span<const T>(_buf.data(), count() - first)};
+}
+
+// copy only the items present, either to the same indices or starting at index 0
+// (storage is allocated if this circular buffer has been moved from, and
+// nothing is copied if cb has no items, which it cannot if it has been moved from)
+template<typename T, std::size_t N, typename S>
+void CircBuf<T, N, S>::copyItems(const CircBuf& cb, bool compact)
+{
+    std::size_t num{cb.count()};
+    std::size_t first{cb.countToEnd()};
+    std::size_t start{compact ? 0 : cb._tail};
+
+    if (_buf.size() == 0)
+    {
+        _buf = S{};
+    }
+    if (num > 0)
+    {
+        std::copy(cb._buf.begin() + cb._tail, cb._buf.begin() + cb._tail + first, _buf.begin() + start);
+        std::copy(cb._buf.begin(), cb._buf.begin() + num - first, _buf.begin() + ((start + first) & (N - 1)));
+    }
+    _tail = start;
+    _head = (start + num) & (N - 1);
+}
@@ -0,0 +1,50 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2010    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#ifndef HEAP_ARRAY_H
+#define HEAP_ARRAY_H
+
+#include <array>
+#include <memory>
+#include <algorithm>
+
+namespace Circular
+{
+namespace Copying
+{
+
+template<typename T, std::size_t N>
+class HeapArray
+{
+public:
+    HeapArray();
+    HeapArray(const HeapArray&);
+    HeapArray(HeapArray&&) noexcept;
+    virtual ~HeapArray() = default;
+    HeapArray& operator=(const HeapArray&);
+    HeapArray& operator=(HeapArray&&) noexcept;
+    T& operator[](std::size_t);
+    const T& operator[](std::size_t) const;
+    T& at(std::size_t);
+    const T& at(std::size_t) const;
+    T* data();
+    const T* data() const;
+    T* begin();
+    const T* begin() const;
+    T* end();
+    const T* end() const;
+    std::size_t size() const;
+protected:
+    std::unique_ptr<std::array<T, N>> _arr;
+};
+
+#include "HeapArray.hpp"
+
+}  // namespace Copying
+}  // namespace Circular
+
+#endif
@@ -0,0 +1,110 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2010    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#ifndef JOURNAL_CIRC_BUF_H
+#define JOURNAL_CIRC_BUF_H
+
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace Circular
+{
+namespace Copying
+{
+
+template<typename T, std::size_t N>
+class JournalCircBuf
+{
+    static constexpr bool power_of_2(std::size_t i) {return (i > 0) && ((i & (i - 1)) == 0);}
+    static_assert(power_of_2(N), "N must be an integer power of 2");
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+    static constexpr std::uint32_t sumInit{2166136261u};
+    struct Cursor
+    {
+        std::uint64_t seq;
+        std::uint64_t head;
+        std::uint64_t tail;
+        std::uint32_t sum;
+        std::uint32_t pad;
+    };
+    struct Header
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t elemLen;
+        std::uint32_t pad;
+        std::uint64_t len;
+        Cursor cursor[2];
+    };
+    struct Slot
+    {
+        std::uint64_t pos;
+        T val;
+        std::uint32_t sum;
+    };
+public:
+    static constexpr std::uint32_t magic{0x4c4e524a};  // "JRNL"
+    static constexpr std::uint32_t version{1};
+    static constexpr std::size_t headerLen{4096};
+    static constexpr std::chrono::milliseconds defaultInterval{100};
+    explicit JournalCircBuf(const std::string&, std::chrono::milliseconds interval = defaultInterval);
+    JournalCircBuf(const JournalCircBuf&) = delete;
+    JournalCircBuf(JournalCircBuf&&) = delete;
+    virtual ~JournalCircBuf();
+    JournalCircBuf& operator=(const JournalCircBuf&) = delete;
+    JournalCircBuf& operator=(JournalCircBuf&&) = delete;
+    static std::size_t fileLen();
+    std::chrono::milliseconds interval() const;
+    void interval(std::chrono::milliseconds);
+    std::size_t torn() const;
+    std::size_t len() const;
+    std::size_t count() const;
+    std::size_t space() const;
+    std::size_t pop(T&);
+    std::size_t push(const T&);
+    std::size_t read(T*, std::size_t);
+    std::size_t write(const T*, std::size_t);
+    std::size_t peek(T*, std::size_t);
+    std::size_t consume(std::size_t);
+    void flush();
+protected:
+    static std::uint32_t checksum(const void*, std::size_t, std::uint32_t);
+    static std::uint32_t cursorSum(const Cursor&);
+    static std::uint32_t slotSum(const Slot&);
+    void putSlot(const T&);
+    void init();
+    void recover();
+    void syncSlots(std::uint64_t, std::uint64_t);
+    void sync(const void*, std::size_t);
+    void batch();
+    int _fd{-1};
+    char* _addr{nullptr};
+    Header* _header{nullptr};
+    Slot* _slots{nullptr};
+    std::uint64_t _head{0};
+    std::uint64_t _tail{0};
+    std::uint64_t _seq{0};
+    std::uint64_t _synced{0};
+    std::size_t _torn{0};
+    std::chrono::milliseconds _interval;
+    std::chrono::steady_clock::time_point _lastFlush;
+};
+
+#include "JournalCircBuf.hpp"
+
+}  // namespace Copying
+}  // namespace Circular
+
+#endif
@@ -0,0 +1,424 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2010    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+// A queue whose buffer and indices live in a memory mapped file, so that the
+// items between the tail and the head survive a restart of the process and can
+// be read again as soon as the file is opened, without parsing or replaying
+// anything.
+//
+// Elements are copied in to and out of the buffer.
+//
+// The head and tail are free running positions that are masked to find a slot,
+// so all N slots are usable.
+//
+// The file starts with a header that records a magic number, the version of the
+// layout, the length of an item and the number of items, followed by two cursor
+// records that hold the head and tail. The slots follow the header, each with the
+// position of its item and a checksum of the item and its position.
+//
+// flush writes the slots written since the last flush to the file, and only then
+// writes the head and tail to the older of the two cursor records, with a higher
+// sequence number and a checksum, and writes that to the file. Items are pushed
+// and popped in memory, and every operation flushes once the durability interval
+// has passed since the last flush, so an interval of zero flushes every operation.
+//
+// When an existing file is opened, the cursor record with the higher sequence
+// number and a valid checksum is used, so a torn write of a cursor record falls
+// back to the previous one. The slots between the tail and the head are then
+// checked. Items popped since the last flush are read again after a restart, so
+// consumers see every item at least once, unless a later item has been pushed
+// into their slots, in which case the tail is moved past them. The head is then
+// moved back to the first slot that does not hold its item with a valid checksum,
+// and the number of items lost, which torn reports, only counts those slots.
+
+template<typename T, std::size_t N>
+JournalCircBuf<T, N>::JournalCircBuf(const std::string& path, std::chrono::milliseconds interval) : _interval{interval}
+{
+    static_assert(sizeof(Header) <= headerLen, "the header must fit in headerLen");
+    struct stat st{};
+    bool create{false};
+    void* addr{nullptr};
+
+    _fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (_fd < 0)
+    {
+        throw errno;
+    }
+    if (fstat(_fd, &st) < 0)
+    {
+        int err{errno};
+        close(_fd);
+        throw err;
+    }
+    if (st.st_size != 0 && std::size_t(st.st_size) != fileLen())
+    {
+        close(_fd);
+        throw EINVAL;
+    }
+    create = (st.st_size == 0);
+    if (create && ftruncate(_fd, fileLen()) < 0)
+    {
+        int err{errno};
+        close(_fd);
+        throw err;
+    }
+    addr = mmap(nullptr, fileLen(), PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if (addr == MAP_FAILED)
+    {
+        int err{errno};
+        close(_fd);
+        throw err;
+    }
+    _addr = static_cast<char*>(addr);
+    _header = reinterpret_cast<Header*>(_addr);
+    _slots = reinterpret_cast<Slot*>(_addr + headerLen);
+    try
+    {
+        if (create)
+        {
+            init();
+        }
+        else
+        {
+            recover();
+        }
+    }
+    catch (...)
+    {
+        munmap(_addr, fileLen());
+        close(_fd);
+        throw;
+    }
+    _lastFlush = std::chrono::steady_clock::now();
+}
+
+template<typename T, std::size_t N>
+JournalCircBuf<T, N>::~JournalCircBuf()
+{
+    try
+    {
+        flush();
+    }
+    catch (int)
+    {
+    }
+    munmap(_addr, fileLen());
+    close(_fd);
+}
+
+// length of the file
+template<typename T, std::size_t N>
+std::size_t JournalCircBuf<T, N>::fileLen()
+{
+    return headerLen + N * sizeof(Slot);
+}
+
+// time allowed between an operation and the flush that makes it durable
+template<typename T, std::size_t N>
+std::chrono::milliseconds JournalCircBuf<T, N>::interval() const
+{
+    return _interval;
+}
+
+template<typename T, std::size_t N>
+void JournalCircBuf<T, N>::interval(std::chrono::milliseconds interval)
+{
+    _interval = interval;
+}
+
+// number of items discarded when the file was opened because they were not
+// completely written
+template<typename T, std::size_t N>
+std::size_t JournalCircBuf<T, N>::torn() const
+{
+    return _torn;
+}
+
+template<typename T, std::size_t N>
+std::size_t JournalCircBuf<T, N>::len() const
+{
+    return N;
+}
+
+// total number of items present in the circular buffer
+template<typename T, std::size_t N>
+std::size_t JournalCircBuf<T, N>::count() const
+{
+    return _head - _tail;
+}
+
+// total space available in the circular buffer
+template<typename T, std::size_t N>
+std::size_t JournalCircBuf<T, N>::space() const
+{
+    return N - count();
+}
+
+// returns number of items popped
+template<typename T, std::size_t N>
+std::size_t JournalCircBuf<T, N>::pop(T& val)
+{
+    if (count() == 0)
+    {
+        return 0;
+    }
+    std::memcpy(&val, &_slots[_tail & (N - 1)].val, sizeof(T));
+    _tail++;
+    batch();
+    return 1;
+}
+
+// returns number of items pushed
+template<typename T, std::size_t N>
+std::size_t JournalCircBuf<T, N>::push(const T& val)
+{
+    if (space() == 0)
+    {
+        return 0;
+    }
+    putSlot(val);
+    batch();
+    return 1;
+}
+
+// returns number of items read
+template<typename T, std::size_t N>
+std::size_t JournalCircBuf<T, N>::read(T* buf, std::size_t len)
+{
+    std::size_t num{peek(buf, len)};
+
+    _tail += num;
+    batch();
+    return num;
+}
+
+// returns number of items written
+template<typename T, std::size_t N>
+std::size_t JournalCircBuf<T, N>::write(const T* buf, std::size_t len)
+{
+    std::size_t num{space()};
+
+    if (len < num)
+    {
+        num = len;
+    }
+    for (std::size_t i{0}; i < num; i++)
+    {
+        putSlot(buf[i]);
+    }
+    batch();
+    return num;
+}
+
+// read data but don't update tail
+// returns number of items read
+template<typename T, std::size_t N>
+std::size_t JournalCircBuf<T, N>::peek(T* buf, std::size_t len)
+{
+    std::size_t num{count()};
+
+    if (len < num)
+    {
+        num = len;
+    }
+    for (std::size_t i{0}; i < num; i++)
+    {
+        std::memcpy(&buf[i], &_slots[(_tail + i) & (N - 1)].val, sizeof(T));
+    }
+    return num;
+}
+
+// returns number of items read
+template<typename T, std::size_t N>
+std::size_t JournalCircBuf<T, N>::consume(std::size_t len)
+{
+    std::size_t num{count()};
+
+    if (len < num)
+    {
+        num = len;
+    }
+    _tail += num;
+    batch();
+    return num;
+}
+
+// make every operation so far durable
+template<typename T, std::size_t N>
+void JournalCircBuf<T, N>::flush()
+{
+    const Cursor& last{_header->cursor[_seq & 1]};
+
+    _lastFlush = std::chrono::steady_clock::now();
+    if (last.head == _head && last.tail == _tail)
+    {
+        return;
+    }
+    // the slots must reach the file before the cursor that covers them
+    syncSlots(_synced, _head);
+    Cursor& next{_header->cursor[(_seq + 1) & 1]};
+    next.seq = _seq + 1;
+    next.head = _head;
+    next.tail = _tail;
+    next.sum = cursorSum(next);
+    sync(_header, sizeof(Header));
+    _seq++;
+    _synced = _head;
+}
+
+// FNV-1a
+template<typename T, std::size_t N>
+std::uint32_t JournalCircBuf<T, N>::checksum(const void* data, std::size_t len, std::uint32_t sum)
+{
+    const unsigned char* p{static_cast<const unsigned char*>(data)};
+
+    for (std::size_t i{0}; i < len; i++)
+    {
+        sum ^= p[i];
+        sum *= 16777619u;
+    }
+    return sum;
+}
+
+template<typename T, std::size_t N>
+std::uint32_t JournalCircBuf<T, N>::cursorSum(const Cursor& cursor)
+{
+    std::uint32_t sum{checksum(&cursor.seq, sizeof(cursor.seq), sumInit)};
+
+    sum = checksum(&cursor.head, sizeof(cursor.head), sum);
+    return checksum(&cursor.tail, sizeof(cursor.tail), sum);
+}
+
+// the position is included so that an item left from a previous lap never matches
+template<typename T, std::size_t N>
+std::uint32_t JournalCircBuf<T, N>::slotSum(const Slot& slot)
+{
+    std::uint32_t sum{checksum(&slot.pos, sizeof(slot.pos), sumInit)};
+
+    return checksum(&slot.val, sizeof(T), sum);
+}
+
+// write an item to the slot at the head
+template<typename T, std::size_t N>
+void JournalCircBuf<T, N>::putSlot(const T& val)
+{
+    Slot& slot{_slots[_head & (N - 1)]};
+
+    slot.pos = _head;
+    std::memcpy(&slot.val, &val, sizeof(T));
+    slot.sum = slotSum(slot);
+    _head++;
+}
+
+template<typename T, std::size_t N>
+void JournalCircBuf<T, N>::init()
+{
+    _header->magic = magic;
+    _header->version = version;
+    _header->elemLen = sizeof(T);
+    _header->len = N;
+    for (Cursor& cursor : _header->cursor)
+    {
+        cursor = Cursor{};
+        cursor.sum = cursorSum(cursor);
+    }
+    sync(_header, sizeof(Header));
+}
+
+template<typename T, std::size_t N>
+void JournalCircBuf<T, N>::recover()
+{
+    const Cursor* cursor{nullptr};
+
+    if (_header->magic != magic
+     || _header->version != version
+     || _header->elemLen != sizeof(T)
+     || _header->len != N)
+    {
+        throw EINVAL;
+    }
+    for (const Cursor& c : _header->cursor)
+    {
+        if (c.sum == cursorSum(c) && c.tail <= c.head && c.head - c.tail <= N
+         && (cursor == nullptr || c.seq > cursor->seq))
+        {
+            cursor = &c;
+        }
+    }
+    if (cursor == nullptr)
+    {
+        throw EIO;
+    }
+    _seq = cursor->seq;
+    _tail = cursor->tail;
+    // skip the items popped since the flush whose slots a later lap has reused,
+    // including a slot whose later write was torn
+    while (_tail != cursor->head
+        && (_slots[_tail & (N - 1)].sum != slotSum(_slots[_tail & (N - 1)])
+         || _slots[_tail & (N - 1)].pos != _tail))
+    {
+        _tail++;
+    }
+    _head = _tail;
+    while (_head != cursor->head
+        && _slots[_head & (N - 1)].sum == slotSum(_slots[_head & (N - 1)])
+        && _slots[_head & (N - 1)].pos == _head)
+    {
+        _head++;
+    }
+    _torn = cursor->head - _head;
+    _synced = _head;
+}
+
+// write the pages holding the slots between two positions to the file
+template<typename T, std::size_t N>
+void JournalCircBuf<T, N>::syncSlots(std::uint64_t from, std::uint64_t to)
+{
+    std::size_t num{to - from};
+    std::size_t first{from & (N - 1)};
+
+    if (num == 0)
+    {
+        return;
+    }
+    if (num >= N)
+    {
+        sync(_slots, N * sizeof(Slot));
+    }
+    else if (first + num <= N)
+    {
+        sync(&_slots[first], num * sizeof(Slot));
+    }
+    else
+    {
+        sync(&_slots[first], (N - first) * sizeof(Slot));
+        sync(_slots, (first + num - N) * sizeof(Slot));
+    }
+}
+
+template<typename T, std::size_t N>
+void JournalCircBuf<T, N>::sync(const void* addr, std::size_t len)
+{
+    std::size_t pageLen{std::size_t(sysconf(_SC_PAGESIZE))};
+    std::size_t start{std::size_t(static_cast<const char*>(addr) - _addr) & ~(pageLen - 1)};
+    std::size_t end{std::size_t(static_cast<const char*>(addr) - _addr) + len};
+
+    if (msync(_addr + start, end - start, MS_SYNC) < 0)
+    {
+        throw errno;
+    }
+}
+
+// flush if the durability interval has passed
+template<typename T, std::size_t N>
+void JournalCircBuf<T, N>::batch()
+{
+    if (std::chrono::steady_clock::now() - _lastFlush >= _interval)
+    {
+        flush();
+    }
+}
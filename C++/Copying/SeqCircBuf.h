@@ -0,0 +1,70 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2010    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#ifndef SEQ_CIRC_BUF_H
+#define SEQ_CIRC_BUF_H
+
+#include <iostream>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+
+namespace Circular
+{
+namespace Copying
+{
+
+template<typename T, std::size_t N>
+class SeqCircBuf;
+
+template<typename T, std::size_t N>
+std::ostream& operator<<(std::ostream&, SeqCircBuf<T, N>&);
+
+template<typename T, std::size_t N>
+class SeqCircBuf
+{
+    static constexpr bool power_of_2(std::size_t i) {return (i > 0) && ((i & (i - 1)) == 0);}
+    static_assert(power_of_2(N), "N must be an integer power of 2");
+    friend std::ostream& operator<< <T, N>(std::ostream&, SeqCircBuf&);
+public:
+    explicit SeqCircBuf(std::uint64_t seq = 0);
+    SeqCircBuf(const SeqCircBuf&) = default;
+    SeqCircBuf(SeqCircBuf&&) = default;
+    virtual ~SeqCircBuf() = default;
+    SeqCircBuf& operator=(const SeqCircBuf&) = default;
+    SeqCircBuf& operator=(SeqCircBuf&&) = default;
+    std::uint64_t head() const;
+    std::uint64_t tail() const;
+    std::size_t len() const;
+    std::array<T, N>& buf();
+    std::size_t countToEnd(std::uint64_t) const;
+    std::size_t countToEnd() const;
+    std::size_t spaceToEnd() const;
+    std::size_t count() const;
+    std::size_t space() const;
+    std::size_t pop(T&);
+    std::size_t push(const T&);
+    std::size_t read(T*, std::size_t);
+    std::size_t write(const T*, std::size_t);
+    std::size_t overwrite(const T*, std::size_t);
+    std::size_t peek(T*, std::size_t);
+    std::size_t peekAt(std::uint64_t, T*, std::size_t);
+    std::size_t consume(std::size_t);
+protected:
+    static std::size_t index(std::uint64_t);
+    std::uint64_t _head;
+    std::uint64_t _tail;
+    std::array<T, N> _buf{};
+};
+
+#include "SeqCircBuf.hpp"
+
+}  // namespace Copying
+}  // namespace Circular
+
+#endif
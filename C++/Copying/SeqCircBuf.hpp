@@ -0,0 +1,259 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2010    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+// A queue implemented using a contiguous buffer with separate sequence numbers
+// for reading and writing.
+//
+// Elements are copied in to and out of the buffer.
+//
+// The head is the sequence number of the next item to be written and the tail is
+// the sequence number of the next item to be read. Both are 64 bit counts of the
+// items that have passed through the buffer, so they never wrap in practice, and
+// they are only masked to index the linear buffer when items are copied.
+//
+// When the head is equal to the tail, the circular buffer is empty.
+// When the head is N more than the tail, the circular buffer is full.
+// Unlike CircBuf, no slot is kept empty to tell the two apart, so all N slots
+// can be used.
+//
+// The sequence numbers are absolute offsets into the stream of items, which a
+// consumer can use to report exact positions. overwrite discards the oldest
+// items to make room instead of failing, and peekAt lets a consumer that keeps
+// its own position find out that items it has not seen have been discarded.
+
+template<typename T, std::size_t N>
+std::ostream& operator<<(std::ostream& ostr, SeqCircBuf<T, N>& cb)
+{
+    ostr << "{";
+    for (std::uint64_t i{cb._tail}; i != cb._head; i++)
+    {
+        ostr << ' ' <<  cb._buf[cb.index(i)];
+    }
+    ostr << " }";
+    return ostr;
+}
+
+// seq is the sequence number of the first item to be written
+template<typename T, std::size_t N>
+SeqCircBuf<T, N>::SeqCircBuf(std::uint64_t seq) : _head{seq}, _tail{seq} {}
+
+template<typename T, std::size_t N>
+std::uint64_t SeqCircBuf<T, N>::head() const
+{
+    return _head;
+}
+
+template<typename T, std::size_t N>
+std::uint64_t SeqCircBuf<T, N>::tail() const
+{
+    return _tail;
+}
+
+template<typename T, std::size_t N>
+std::size_t SeqCircBuf<T, N>::len() const
+{
+    return N;
+}
+
+template<typename T, std::size_t N>
+std::array<T, N>& SeqCircBuf<T, N>::buf()
+{
+    return _buf;
+}
+
+// number of items present from seq up to the end of the linear buffer or
+// the end of the circular buffer, whichever is smaller
+// this special version (with an argument) is required by SeqCircBuf::peekAt()
+template<typename T, std::size_t N>
+std::size_t SeqCircBuf<T, N>::countToEnd(std::uint64_t seq) const
+{
+    std::size_t countEndLinearBuf{N - index(seq)};
+    std::size_t countEndCircBuf(_head - seq);
+    return countEndCircBuf < countEndLinearBuf ? countEndCircBuf : countEndLinearBuf;
+}
+
+// number of items present up to the end of the linear buffer or
+// the end of the circular buffer, whichever is smaller
+template<typename T, std::size_t N>
+std::size_t SeqCircBuf<T, N>::countToEnd() const
+{
+    return countToEnd(_tail);
+}
+
+// space available to the end of the linear buffer or
+// the end of the circular buffer, whichever is smaller
+template<typename T, std::size_t N>
+std::size_t SeqCircBuf<T, N>::spaceToEnd() const
+{
+    std::size_t spaceEndLinearBuf{N - index(_head)};
+    std::size_t spaceEndCircBuf{space()};
+    return spaceEndLinearBuf < spaceEndCircBuf ? spaceEndLinearBuf : spaceEndCircBuf;
+}
+
+// total number of items present in the circular buffer
+template<typename T, std::size_t N>
+std::size_t SeqCircBuf<T, N>::count() const
+{
+    return std::size_t(_head - _tail);
+}
+
+// total space available for items in the circular buffer
+template<typename T, std::size_t N>
+std::size_t SeqCircBuf<T, N>::space() const
+{
+    return N - count();
+}
+
+// returns number of items popped
+template<typename T, std::size_t N>
+std::size_t SeqCircBuf<T, N>::pop(T& val)
+{
+    if (count() == 0)
+    {
+        return 0;
+    }
+    val = _buf[index(_tail)];
+    _tail++;
+    return 1;
+}
+
+// returns number of items pushed
+template<typename T, std::size_t N>
+std::size_t SeqCircBuf<T, N>::push(const T& val)
+{
+    if (space() == 0)
+    {
+        return 0;
+    }
+    _buf[index(_head)] = val;
+    _head++;
+    return 1;
+}
+
+// returns number of items read
+template<typename T, std::size_t N>
+std::size_t SeqCircBuf<T, N>::read(T* buf, std::size_t len)
+{
+    std::size_t ret{peekAt(_tail, buf, len)};
+
+    _tail += ret;
+    return ret;
+}
+
+// returns number of items written
+template<typename T, std::size_t N>
+std::size_t SeqCircBuf<T, N>::write(const T* buf, std::size_t len)
+{
+    std::size_t ret{0};
+
+    while (1)
+    {
+        std::size_t num{spaceToEnd()};
+        if (len < num)
+        {
+            num = len;
+        }
+        if (num <= 0)
+        {
+            break;
+        }
+        std::copy(buf, buf + num, _buf.begin() + index(_head));
+        _head += num;
+        buf += num;
+        len -= num;
+        ret += num;
+    }
+    return ret;
+}
+
+// write all of the items, discarding the oldest items to make room
+// (only the last N items are kept when more than N are written)
+// returns number of items written
+template<typename T, std::size_t N>
+std::size_t SeqCircBuf<T, N>::overwrite(const T* buf, std::size_t len)
+{
+    std::size_t skip{0};
+
+    if (len > N)
+    {
+        skip = len - N;
+        _head += skip;
+        _tail = _head;
+    }
+    if (len - skip > space())
+    {
+        _tail += len - skip - space();
+    }
+    return skip + write(buf + skip, len - skip);
+}
+
+// read items but don't update tail
+// (2 consecutive peek operations with the same arguments will produce the same result)
+// returns number of items read
+template<typename T, std::size_t N>
+std::size_t SeqCircBuf<T, N>::peek(T* buf, std::size_t len)
+{
+    return peekAt(_tail, buf, len);
+}
+
+// read items starting at sequence number seq but don't update tail
+// throws ERANGE if the item at seq has already been removed (the gap is
+// tail - seq items) or EINVAL if seq is past the head
+// returns number of items read
+template<typename T, std::size_t N>
+std::size_t SeqCircBuf<T, N>::peekAt(std::uint64_t seq, T* buf, std::size_t len)
+{
+    std::size_t ret{0};
+
+    if (seq < _tail)
+    {
+        throw ERANGE;
+    }
+    if (seq > _head)
+    {
+        throw EINVAL;
+    }
+    while (1)
+    {
+        std::size_t num{countToEnd(seq)};
+        if (len < num)
+        {
+            num = len;
+        }
+        if (num <= 0)
+        {
+            break;
+        }
+        std::copy(_buf.begin() + index(seq), _buf.begin() + index(seq) + num, buf);
+        seq += num;
+        buf += num;
+        len -= num;
+        ret += num;
+    }
+    return ret;
+}
+
+// returns number of items removed
+template<typename T, std::size_t N>
+std::size_t SeqCircBuf<T, N>::consume(std::size_t len)
+{
+    std::size_t num{count()};
+
+    if (len < num)
+    {
+        num = len;
+    }
+    _tail += num;
+    return num;
+}
+
+// index into the linear buffer of the item with sequence number seq
+template<typename T, std::size_t N>
+std::size_t SeqCircBuf<T, N>::index(std::uint64_t seq)
+{
+    return std::size_t(seq & (N - 1));
+}
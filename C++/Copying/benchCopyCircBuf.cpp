@@ -0,0 +1,104 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2010    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+// Measures the time taken to copy a large circular buffer as the number of items
+// in it grows, against copying the whole buffer as copying used to do.
+//
+// Each circular buffer has its items wrapped around the end of the buffer, so
+// the compacted copies have to join the two parts.
+
+#include "CircBuf.h"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <array>
+#include <chrono>
+
+using namespace Circular::Copying;
+
+constexpr std::size_t circBufLen{1 << 20};
+constexpr std::size_t numIter{200};
+
+typedef int Elem;
+typedef CircBuf<Elem, circBufLen> Buf;
+
+volatile Elem sink;
+
+// fill num items starting half way along the buffer
+void fill(Buf& cb, std::size_t num)
+{
+    cb.head(circBufLen / 2);
+    cb.tail(circBufLen / 2);
+    for (std::size_t i{0}; i < num; i++)
+    {
+        cb.push(Elem(i));
+    }
+}
+
+// returns microseconds per copy
+template<typename F>
+double timeCopy(F&& func)
+{
+    auto start{std::chrono::steady_clock::now()};
+
+    for (std::size_t i{0}; i < numIter; i++)
+    {
+        func();
+    }
+    std::chrono::duration<double, std::micro> usecs{std::chrono::steady_clock::now() - start};
+    return usecs.count() / numIter;
+}
+
+int main()
+{
+    auto src{std::make_unique<Buf>()};
+    auto dst{std::make_unique<Buf>()};
+    auto arr{std::make_unique<std::array<Elem, circBufLen>>()};
+    std::size_t percents[]{0, 1, 10, 50, 100};
+
+    std::cout << "microseconds per copy of " << circBufLen << " slots" << std::endl;
+    std::cout << std::setw(8) << "items %"
+              << std::setw(12) << "whole"
+              << std::setw(12) << "construct"
+              << std::setw(12) << "compact"
+              << std::setw(12) << "assign"
+              << std::setw(12) << "compact" << std::endl;
+    for (auto percent : percents)
+    {
+        src->head(0);
+        src->tail(0);
+        fill(*src, (circBufLen - 1) * percent / 100);
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(8) << percent
+                  << std::setw(12) << timeCopy([&]()
+                                               {
+                                                   *arr = src->buf();
+                                                   sink = (*arr)[circBufLen / 2];
+                                               })
+                  << std::setw(12) << timeCopy([&]()
+                                               {
+                                                   auto cb{std::make_unique<Buf>(*src)};
+                                                   sink = Elem(cb->count());
+                                               })
+                  << std::setw(12) << timeCopy([&]()
+                                               {
+                                                   auto cb{std::make_unique<Buf>(*src, true)};
+                                                   sink = Elem(cb->count());
+                                               })
+                  << std::setw(12) << timeCopy([&]()
+                                               {
+                                                   *dst = *src;
+                                                   sink = Elem(dst->count());
+                                               })
+                  << std::setw(12) << timeCopy([&]()
+                                               {
+                                                   dst->assign(*src, true);
+                                                   sink = Elem(dst->count());
+                                               }) << std::endl;
+    }
+    return 0;
+}
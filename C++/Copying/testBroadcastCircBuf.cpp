@@ -0,0 +1,237 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#include "BroadcastCircBuf.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <vector>
+#include <thread>
+
+using namespace Circular::Copying;
+
+constexpr std::size_t circBufLen{8};
+constexpr std::size_t numConsumers{3};
+constexpr std::size_t maxNumIter{(circBufLen + circBufLen / 2)};
+
+typedef int Elem;
+
+struct TestPushPopData
+{
+    std::size_t numIter;
+    std::array<std::size_t, maxNumIter> expectedPushNum;
+    std::array<std::size_t, maxNumIter> expectedPopNum;
+};
+
+TestPushPopData testPushPopData
+{
+    .numIter{maxNumIter},
+    .expectedPushNum{1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0},
+    .expectedPopNum{1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0}
+};
+
+void testPushPopFunc(TestPushPopData* data)
+{
+    BroadcastCircBuf<Elem, circBufLen, numConsumers> cb;
+
+    for (std::size_t i{0}; i < data->numIter; i++)
+    {
+        std::size_t num{cb.push(Elem(i + 1))};
+        ASSERT_EQ(num, data->expectedPushNum.at(i));
+    }
+    ASSERT_EQ(cb.count(), circBufLen);
+    ASSERT_EQ(cb.space(), 0);
+    // every consumer receives every item
+    for (std::size_t c{0}; c < numConsumers; c++)
+    {
+        ASSERT_EQ(cb.lag(c), circBufLen);
+        for (std::size_t i{0}; i < data->numIter; i++)
+        {
+            Elem val{0};
+            std::size_t num{cb.pop(c, val)};
+            ASSERT_EQ(num, data->expectedPopNum.at(i));
+            ASSERT_EQ(val, num == 0 ? 0 : Elem(i + 1));
+        }
+        ASSERT_EQ(cb.lag(c), 0);
+        // space is only freed once the slowest consumer has read
+        ASSERT_EQ(cb.space(), c == numConsumers - 1 ? circBufLen : 0);
+    }
+    ASSERT_EQ(cb.count(), 0);
+}
+
+struct TestBackpressureData
+{
+    std::size_t fastLen;
+    std::size_t slowLen;
+    std::size_t writeLen;
+    std::size_t expectedWriteNum;
+};
+
+TestBackpressureData testBackpressureData
+{
+    .fastLen{8},
+    .slowLen{3},
+    .writeLen{8},
+    .expectedWriteNum{3}
+};
+
+void testBackpressureFunc(TestBackpressureData* data)
+{
+    BroadcastCircBuf<Elem, circBufLen, numConsumers> cb;
+    Elem buf[circBufLen]{};
+
+    ASSERT_EQ(cb.write(buf, circBufLen), circBufLen);
+    for (std::size_t c{0}; c < numConsumers - 1; c++)
+    {
+        ASSERT_EQ(cb.consume(c, data->fastLen), data->fastLen);
+    }
+    ASSERT_EQ(cb.consume(numConsumers - 1, data->slowLen), data->slowLen);
+    ASSERT_EQ(cb.lag(0), circBufLen - data->fastLen);
+    ASSERT_EQ(cb.lag(numConsumers - 1), circBufLen - data->slowLen);
+    ASSERT_EQ(cb.space(), data->slowLen);
+    ASSERT_EQ(cb.write(buf, data->writeLen), data->expectedWriteNum);
+    ASSERT_EQ(cb.space(), 0);
+    ASSERT_EQ(cb.lag(0), data->expectedWriteNum);
+}
+
+struct TestReadWriteData
+{
+    std::array<const Elem, circBufLen> str;
+    std::size_t strLen;
+    std::size_t numIter;
+    std::array<std::size_t, maxNumIter> expectedWriteNum;
+    std::array<std::size_t, maxNumIter> expectedReadNum;
+};
+
+TestReadWriteData testReadWriteData
+{
+    .str{1, 2, 3, 4, 5},
+    .strLen{5},
+    .numIter{4},
+    .expectedWriteNum{5, 5, 5, 5},
+    .expectedReadNum{5, 5, 5, 5}
+};
+
+TestReadWriteData testReadWriteOverflowData
+{
+    .str{1, 2, 3, 4, 5, 6, 7, 8},
+    .strLen{8},
+    .numIter{4},
+    .expectedWriteNum{8, 8, 8, 8},
+    .expectedReadNum{8, 8, 8, 8}
+};
+
+void testReadWriteFunc(TestReadWriteData* data)
+{
+    BroadcastCircBuf<Elem, circBufLen, numConsumers> cb;
+
+    // each iteration starts at a different offset so that the data wraps
+    for (std::size_t i{0}; i < data->numIter; i++)
+    {
+        std::size_t num{cb.write(data->str.data(), data->strLen)};
+        ASSERT_EQ(num, data->expectedWriteNum.at(i));
+        for (std::size_t c{0}; c < numConsumers; c++)
+        {
+            Elem buf[circBufLen]{};
+            num = cb.peek(c, buf, circBufLen);
+            ASSERT_EQ(num, data->expectedReadNum.at(i));
+            num = cb.read(c, buf, circBufLen);
+            ASSERT_EQ(num, data->expectedReadNum.at(i));
+            for (std::size_t j{0}; j < num; j++)
+            {
+                ASSERT_EQ(buf[j], data->str.at(j));
+            }
+        }
+        ASSERT_EQ(cb.count(), 0);
+    }
+}
+
+struct TestMultithreadedData
+{
+    std::size_t numElem;
+    std::size_t chunkLen;
+};
+
+TestMultithreadedData testMultithreadedData
+{
+    .numElem{1000000},
+    .chunkLen{1}
+};
+
+TestMultithreadedData testMultithreadedChunkData
+{
+    .numElem{1000000},
+    .chunkLen{5}
+};
+
+void testMultithreadedFunc(TestMultithreadedData* data)
+{
+    BroadcastCircBuf<Elem, circBufLen, numConsumers> cb;
+    std::vector<std::thread> consumers;
+
+    for (std::size_t c{0}; c < numConsumers; c++)
+    {
+        consumers.emplace_back([&cb, data, c]()
+                               {
+                                   Elem expected{0};
+                                   while (std::size_t(expected) < data->numElem)
+                                   {
+                                       Elem buf[circBufLen]{};
+                                       std::size_t num{data->chunkLen == 1 ? cb.pop(c, buf[0]) : cb.read(c, buf, data->chunkLen)};
+                                       if (num == 0)
+                                       {
+                                           std::this_thread::yield();
+                                       }
+                                       for (std::size_t i{0}; i < num; i++)
+                                       {
+                                           ASSERT_EQ(buf[i], expected++);
+                                       }
+                                   }
+                               });
+    }
+    std::thread producer([&cb, data]()
+                    {
+                        Elem next{0};
+                        while (std::size_t(next) < data->numElem)
+                        {
+                            Elem buf[circBufLen]{};
+                            std::size_t len{data->chunkLen};
+                            if (data->numElem - next < len)
+                            {
+                                len = data->numElem - next;
+                            }
+                            for (std::size_t i{0}; i < len; i++)
+                            {
+                                buf[i] = next + Elem(i);
+                            }
+                            std::size_t num{len == 1 ? cb.push(buf[0]) : cb.write(buf, len)};
+                            if (num == 0)
+                            {
+                                std::this_thread::yield();
+                            }
+                            next += Elem(num);
+                        }
+                    });
+    producer.join();
+    for (auto& t : consumers)
+    {
+        t.join();
+    }
+    ASSERT_EQ(cb.count(), 0);
+}
+
+TEST(testBroadcastCircBuf, pushPop) {testPushPopFunc(&testPushPopData);}
+TEST(testBroadcastCircBuf, backpressure) {testBackpressureFunc(&testBackpressureData);}
+TEST(testBroadcastCircBuf, readWrite) {testReadWriteFunc(&testReadWriteData);}
+TEST(testBroadcastCircBuf, readWriteOverflow) {testReadWriteFunc(&testReadWriteOverflowData);}
+TEST(testBroadcastCircBuf, multithreaded) {testMultithreadedFunc(&testMultithreadedData);}
+TEST(testBroadcastCircBuf, multithreadedChunk) {testMultithreadedFunc(&testMultithreadedChunkData);}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
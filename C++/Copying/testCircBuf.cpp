@@ -21,12 +21,28 @@ struct TestCopyConstructorData
 {
     std::size_t head;
     std::size_t tail;
+    bool compact;
 };
 
 TestCopyConstructorData testCopyConstructorData
 {
     .head{2},
-    .tail{6}
+    .tail{6},
+    .compact{false}
+};
+
+TestCopyConstructorData testCompactCopyConstructorData
+{
+    .head{2},
+    .tail{6},
+    .compact{true}
+};
+
+TestCopyConstructorData testTailLtHeadCompactCopyConstructorData
+{
+    .head{5},
+    .tail{3},
+    .compact{true}
 };
 
 void testCopyConstructorFunc(TestCopyConstructorData* data)
@@ -40,18 +56,21 @@ void testCopyConstructorFunc(TestCopyConstructorData* data)
     }
     cb1.head(data->head);
     cb1.tail(data->tail);
+    std::size_t num{cb1.count()};
 
     // construct cb2
-    CircBuf<Elem, circBufLen> cb2(cb1);
+    CircBuf<Elem, circBufLen> cb2(cb1, data->compact);
 
-    // check that cb2 is now a copy of cb1
+    // check that cb2 holds a copy of the items in cb1
     std::array<Elem, circBufLen>& p2{cb2.buf()};
-    for (Elem i{0}; i < Elem(circBufLen); i++)
+    std::size_t start{data->compact ? 0 : data->tail};
+    for (std::size_t i{0}; i < num; i++)
     {
-        ASSERT_EQ(p2.at(i), i);
+        ASSERT_EQ(p2.at((start + i) % circBufLen), Elem((data->tail + i) % circBufLen));
     }
-    ASSERT_EQ(cb2.head(), data->head);
-    ASSERT_EQ(cb2.tail(), data->tail);
+    ASSERT_EQ(cb2.head(), (start + num) % circBufLen);
+    ASSERT_EQ(cb2.tail(), start);
+    ASSERT_EQ(cb2.count(), num);
 
     // check that cb1 has remained the same
     std::array<Elem, circBufLen>& p3{cb1.buf()};
@@ -113,12 +132,28 @@ struct TestCopyAssignmentData
 {
     std::size_t head;
     std::size_t tail;
+    bool compact;
 };
 
 TestCopyAssignmentData testCopyAssignmentData
 {
     .head{2},
-    .tail{6}
+    .tail{6},
+    .compact{false}
+};
+
+TestCopyAssignmentData testCompactCopyAssignmentData
+{
+    .head{2},
+    .tail{6},
+    .compact{true}
+};
+
+TestCopyAssignmentData testTailLtHeadCompactCopyAssignmentData
+{
+    .head{5},
+    .tail{3},
+    .compact{true}
 };
 
 void testCopyAssignmentFunc(TestCopyAssignmentData* data)
@@ -128,29 +163,40 @@ void testCopyAssignmentFunc(TestCopyAssignmentData* data)
     std::array<Elem, circBufLen>& p1{cb1.buf()};
     for (Elem i{0}; i < Elem(circBufLen); i++)
     {
-        p1.at(i) = i;
+        p1.at(i) = i + 1;
     }
     cb1.head(data->head);
     cb1.tail(data->tail);
+    std::size_t num{cb1.count()};
 
     // construct cb2
     CircBuf<Elem, circBufLen> cb2;
-    cb2 = cb1;
+    if (data->compact)
+    {
+        cb2.assign(cb1, true);
+    }
+    else
+    {
+        cb2 = cb1;
+    }
 
-    // check that cb2 is now a copy of cb1
+    // check that cb2 holds a copy of the items in cb1 and nothing else
     std::array<Elem, circBufLen>& p2{cb2.buf()};
-    for (Elem i{0}; i < Elem(circBufLen); i++)
+    std::size_t start{data->compact ? 0 : data->tail};
+    for (std::size_t i{0}; i < circBufLen; i++)
     {
-        ASSERT_EQ(p2.at(i), i);
+        Elem val{i < num ? Elem((data->tail + i) % circBufLen + 1) : 0};
+        ASSERT_EQ(p2.at((start + i) % circBufLen), val);
     }
-    ASSERT_EQ(cb2.head(), data->head);
-    ASSERT_EQ(cb2.tail(), data->tail);
+    ASSERT_EQ(cb2.head(), (start + num) % circBufLen);
+    ASSERT_EQ(cb2.tail(), start);
+    ASSERT_EQ(cb2.count(), num);
 
     // check that cb1 has remained the same
     std::array<Elem, circBufLen>& p3{cb1.buf()};
     for (Elem i{0}; i < Elem(circBufLen); i++)
     {
-        ASSERT_EQ(p3.at(i), i);
+        ASSERT_EQ(p3.at(i), i + 1);
     }
     ASSERT_EQ(cb1.head(), data->head);
     ASSERT_EQ(cb1.tail(), data->tail);
@@ -697,6 +743,80 @@ void testPeekConsumeFunc(TestPeekConsumeData* data)
     }
 }
 
+struct TestReadableSpansData
+{
+    std::array<const Elem, circBufLen> str;
+    std::size_t strLen;
+    std::size_t start;
+    std::size_t end;
+    std::size_t consumeLen;
+    std::size_t numIter;
+    std::array<std::size_t, maxNumIter> expectedFirstLen;
+    std::array<std::size_t, maxNumIter> expectedSecondLen;
+};
+
+TestReadableSpansData testReadableSpansData
+{
+    .str{1, 2, 3, 4, 5, 6, 7},
+    .strLen{7},
+    .start{0},
+    .end{7},
+    .consumeLen{3},
+    .numIter{4},
+    .expectedFirstLen{7, 4, 1, 0},
+    .expectedSecondLen{0, 0, 0, 0}
+};
+
+TestReadableSpansData testTailGtHeadReadableSpansData
+{
+    .str{1, 2, 3, 4, 5, 6, 7},
+    .strLen{7},
+    .start{5},
+    .end{4},
+    .consumeLen{2},
+    .numIter{5},
+    .expectedFirstLen{3, 1, 3, 1, 0},
+    .expectedSecondLen{4, 4, 0, 0, 0}
+};
+
+void testReadableSpansFunc(TestReadableSpansData* data)
+{
+    CircBuf<Elem, circBufLen> cb;
+
+    std::array<Elem, circBufLen>& p{cb.buf()};
+    std::size_t n{data->start};
+    for (std::size_t i{0}; i < data->strLen; i++)
+    {
+        p.at(n) = data->str.at(i);
+        if (++n >= cb.len())
+        {
+            n = 0;
+        }
+    }
+    cb.head(data->end);
+    cb.tail(data->start);
+    std::size_t offset{0};
+    for (std::size_t i{0}; i < data->numIter; i++)
+    {
+        auto [first, second]{cb.readableSpans()};
+        ASSERT_EQ(first.size(), data->expectedFirstLen.at(i));
+        ASSERT_EQ(second.size(), data->expectedSecondLen.at(i));
+        // the spans refer to the buffer itself
+        ASSERT_EQ(first.data(), p.data() + cb.tail());
+        std::size_t k{offset};
+        for (const auto& e : first)
+        {
+            ASSERT_EQ(e, data->str.at(k++));
+        }
+        for (const auto& e : second)
+        {
+            ASSERT_EQ(e, data->str.at(k++));
+        }
+        ASSERT_EQ(k, data->strLen);
+        offset += cb.consume(data->consumeLen);
+    }
+}
+
 struct TestMultithreadedData
 {
     std::size_t numIter;
@@ -733,10 +853,136 @@ void testMultithreadedFunc(TestMultithreadedData* data)
     t.join();
 }
 
+struct TestHeapMoveData
+{
+    std::size_t head;
+    std::size_t tail;
+};
+
+TestHeapMoveData testHeapMoveData
+{
+    .head{2},
+    .tail{6}
+};
+
+void testHeapMoveFunc(TestHeapMoveData* data)
+{
+    // construct cb1
+    HeapCircBuf<Elem, circBufLen> cb1;
+    HeapArray<Elem, circBufLen>& p1{cb1.buf()};
+    for (std::size_t i{0}; i < circBufLen; i++)
+    {
+        p1[i] = Elem(i);
+    }
+    cb1.head(data->head);
+    cb1.tail(data->tail);
+    const Elem* items{cb1.buf().data()};
+
+    // moving only moves the pointer to the items
+    HeapCircBuf<Elem, circBufLen> cb2(std::move(cb1));
+    ASSERT_EQ(cb2.buf().data(), items);
+    HeapArray<Elem, circBufLen>& p2{cb2.buf()};
+    for (std::size_t i{0}; i < circBufLen; i++)
+    {
+        ASSERT_EQ(p2[i], Elem(i));
+    }
+    ASSERT_EQ(cb2.head(), data->head);
+    ASSERT_EQ(cb2.tail(), data->tail);
+    ASSERT_EQ(cb1.head(), 0);
+    ASSERT_EQ(cb1.tail(), 0);
+
+    // cb1 has no storage, so it is both empty and full
+    Elem val{0};
+    std::array<Elem, circBufLen> vals{};
+    ASSERT_EQ(cb1.buf().size(), 0);
+    ASSERT_EQ(cb1.buf().data(), nullptr);
+    ASSERT_EQ(cb1.len(), 0);
+    ASSERT_EQ(cb1.count(), 0);
+    ASSERT_EQ(cb1.space(), 0);
+    ASSERT_EQ(cb1.spaceToEnd(), 0);
+    ASSERT_EQ(cb1.push(Elem(1)), 0);
+    ASSERT_EQ(cb1.pop(val), 0);
+    ASSERT_EQ(cb1.write(vals.data(), circBufLen), 0);
+    ASSERT_EQ(cb1.read(vals.data(), circBufLen), 0);
+    auto spans{cb1.readableSpans()};
+    ASSERT_EQ(spans.first.size() + spans.second.size(), 0);
+
+    // assignment moves the pointer and leaves cb2 with no storage,
+    // and assigning to cb1 lets it be used again
+    HeapCircBuf<Elem, circBufLen> cb3;
+    cb3 = std::move(cb2);
+    ASSERT_EQ(cb3.buf().data(), items);
+    ASSERT_EQ(cb2.buf().data(), nullptr);
+    ASSERT_EQ(cb2.len(), 0);
+    ASSERT_EQ(cb2.head(), 0);
+    ASSERT_EQ(cb2.tail(), 0);
+    HeapCircBuf<Elem, circBufLen> cb5;
+    const Elem* items5{cb5.buf().data()};
+    cb1 = std::move(cb5);
+    ASSERT_EQ(cb1.buf().data(), items5);
+    ASSERT_EQ(cb1.push(Elem(1)), 1);
+    ASSERT_EQ(cb1.count(), 1);
+    HeapArray<Elem, circBufLen>& p3{cb3.buf()};
+    for (std::size_t i{0}; i < circBufLen; i++)
+    {
+        ASSERT_EQ(p3[i], Elem(i));
+    }
+
+    // copying copies the items into storage of its own
+    HeapCircBuf<Elem, circBufLen> cb4(cb3);
+    ASSERT_NE(cb4.buf().data(), cb3.buf().data());
+    HeapArray<Elem, circBufLen>& p4{cb4.buf()};
+    for (std::size_t i{cb4.tail()}; i != cb4.head(); i = (i + 1) % circBufLen)
+    {
+        ASSERT_EQ(p4[i], Elem(i));
+    }
+    ASSERT_EQ(cb4.head(), data->head);
+    ASSERT_EQ(cb4.tail(), data->tail);
+}
+
+TEST(testCircBuf, copyMovedFrom)
+{
+    HeapCircBuf<Elem, circBufLen> cb1;
+    HeapCircBuf<Elem, circBufLen> cb2;
+    Elem val{0};
+
+    ASSERT_EQ(cb1.push(Elem(1)), 1);
+    HeapCircBuf<Elem, circBufLen> cb3(std::move(cb1));
+
+    // copying from a moved from circular buffer copies no items
+    HeapCircBuf<Elem, circBufLen> cb4(cb1);
+    ASSERT_EQ(cb4.len(), circBufLen);
+    ASSERT_EQ(cb4.count(), 0);
+    ASSERT_EQ(cb4.push(Elem(2)), 1);
+    ASSERT_EQ(cb2.push(Elem(3)), 1);
+    cb2 = cb1;
+    ASSERT_EQ(cb2.count(), 0);
+    ASSERT_EQ(cb2.len(), circBufLen);
+
+    // assigning to a moved from circular buffer gives it storage again
+    cb4.assign(cb3, true);
+    cb1 = cb4;
+    ASSERT_EQ(cb1.len(), circBufLen);
+    ASSERT_EQ(cb1.count(), 1);
+    ASSERT_EQ(cb1.pop(val), 1);
+    ASSERT_EQ(val, 1);
+    ASSERT_EQ(cb1.push(Elem(4)), 1);
+    HeapCircBuf<Elem, circBufLen> cb5(std::move(cb3));
+    cb3.assign(cb1, true);
+    ASSERT_EQ(cb3.count(), 1);
+    ASSERT_EQ(cb3.pop(val), 1);
+    ASSERT_EQ(val, 4);
+}
+
 TEST(testCircBuf, copyConstructor) {testCopyConstructorFunc(&testCopyConstructorData);}
+TEST(testCircBuf, compactCopyConstructor) {testCopyConstructorFunc(&testCompactCopyConstructorData);}
+TEST(testCircBuf, tailLtHeadCompactCopyConstructor) {testCopyConstructorFunc(&testTailLtHeadCompactCopyConstructorData);}
 TEST(testCircBuf, moveConstructor) {testMoveConstructorFunc(&testMoveConstructorData);}
 TEST(testCircBuf, copyAssignment) {testCopyAssignmentFunc(&testCopyAssignmentData);}
+TEST(testCircBuf, compactCopyAssignment) {testCopyAssignmentFunc(&testCompactCopyAssignmentData);}
+TEST(testCircBuf, tailLtHeadCompactCopyAssignment) {testCopyAssignmentFunc(&testTailLtHeadCompactCopyAssignmentData);}
 TEST(testCircBuf, moveAssignment) {testMoveAssignmentFunc(&testMoveAssignmentData);}
+TEST(testCircBuf, heapMove) {testHeapMoveFunc(&testHeapMoveData);}
 TEST(testCircBuf, space) {testSpaceFunc(&testSpaceData);}
 TEST(testCircBuf, count) {testCountFunc(&testCountData);}
 TEST(testCircBuf, pop) {testPopFunc(&testPopData);}
@@ -755,6 +1001,8 @@ TEST(testCircBuf, peekConsumeIntoSmallerBuffer) {testPeekConsumeFunc(&testPeekCo
 TEST(testCircBuf, peekConsumeIntoLargerBuffer) {testPeekConsumeFunc(&testPeekConsumeIntoLargerBufferData);}
 TEST(testCircBuf, tailGtHeadPeekConsumeIntoSmallerBuffer) {testPeekConsumeFunc(&testTailGtHeadPeekConsumeIntoSmallerBufferData);}
 TEST(testCircBuf, tailGtHedPeekConsumeIntoLargerBuffer) {testPeekConsumeFunc(&testTailGtHeadPeekConsumeIntoLargerBufferData);}
+TEST(testCircBuf, readableSpans) {testReadableSpansFunc(&testReadableSpansData);}
+TEST(testCircBuf, tailGtHeadReadableSpans) {testReadableSpansFunc(&testTailGtHeadReadableSpansData);}
 TEST(testCircBuf, multithreaded) {testMultithreadedFunc(&testMultithreadedData);}
 
 int main(int argc, char** argv)
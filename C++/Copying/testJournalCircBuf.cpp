@@ -0,0 +1,210 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2010    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#include "JournalCircBuf.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <chrono>
+#include <string>
+#include <unistd.h>
+#include <fcntl.h>
+
+using namespace Circular::Copying;
+
+constexpr std::size_t circBufLen{8};
+
+typedef int Elem;
+typedef JournalCircBuf<Elem, circBufLen> Journal;
+
+// a file name that is unique to the test and removed afterwards
+struct TempPath
+{
+    TempPath(const char* name) : path{"/tmp/testJournalCircBuf." + std::string(name) + "." + std::to_string(getpid())}
+    {
+        unlink(path.c_str());
+    }
+    ~TempPath()
+    {
+        unlink(path.c_str());
+    }
+    std::string path;
+};
+
+TEST(testJournalCircBuf, pushPop)
+{
+    TempPath tmp("pushPop");
+    Journal cb(tmp.path, std::chrono::milliseconds(0));
+
+    // all of the slots are usable
+    for (std::size_t i{0}; i < circBufLen; i++)
+    {
+        ASSERT_EQ(cb.push(Elem(i + 1)), 1);
+    }
+    ASSERT_EQ(cb.push(Elem(99)), 0);
+    ASSERT_EQ(cb.count(), circBufLen);
+    ASSERT_EQ(cb.space(), 0);
+    for (std::size_t i{0}; i < circBufLen; i++)
+    {
+        Elem val{0};
+        ASSERT_EQ(cb.pop(val), 1);
+        ASSERT_EQ(val, Elem(i + 1));
+    }
+    Elem val{0};
+    ASSERT_EQ(cb.pop(val), 0);
+    ASSERT_EQ(cb.torn(), 0);
+}
+
+TEST(testJournalCircBuf, restart)
+{
+    TempPath tmp("restart");
+    std::array<Elem, circBufLen> in{1, 2, 3, 4, 5, 6, 7, 8};
+    std::array<Elem, circBufLen> out{};
+
+    {
+        Journal cb(tmp.path);
+        // wrap the items past the end of the linear buffer
+        ASSERT_EQ(cb.write(in.data(), 5), 5);
+        ASSERT_EQ(cb.consume(5), 5);
+        ASSERT_EQ(cb.write(in.data(), 6), 6);
+        ASSERT_EQ(cb.read(out.data(), 2), 2);
+    }
+    {
+        Journal cb(tmp.path);
+        ASSERT_EQ(cb.count(), 4);
+        ASSERT_EQ(cb.peek(out.data(), out.size()), 4);
+        for (std::size_t i{0}; i < 4; i++)
+        {
+            ASSERT_EQ(out[i], in[i + 2]);
+        }
+        ASSERT_EQ(cb.consume(1), 1);
+    }
+    {
+        Journal cb(tmp.path);
+        ASSERT_EQ(cb.count(), 3);
+        ASSERT_EQ(cb.read(out.data(), out.size()), 3);
+        ASSERT_EQ(out[0], in[3]);
+    }
+    // a journal with a different layout is rejected
+    ASSERT_THROW((JournalCircBuf<Elem, 2 * circBufLen>(tmp.path)), int);
+    ASSERT_THROW((JournalCircBuf<long long, circBufLen>(tmp.path)), int);
+}
+
+TEST(testJournalCircBuf, batch)
+{
+    TempPath tmp("batch");
+    Journal cb(tmp.path, std::chrono::hours(1));
+
+    ASSERT_EQ(cb.push(Elem(1)), 1);
+    ASSERT_EQ(cb.push(Elem(2)), 1);
+    {
+        // nothing has been flushed within the interval
+        Journal other(tmp.path);
+        ASSERT_EQ(other.count(), 0);
+    }
+    cb.flush();
+    {
+        Journal other(tmp.path);
+        ASSERT_EQ(other.count(), 2);
+    }
+}
+
+TEST(testJournalCircBuf, torn)
+{
+    TempPath tmp("torn");
+    Elem val{0};
+
+    // only flushed by the destructor, to cursor record 1
+    {
+        Journal cb(tmp.path, std::chrono::hours(1));
+        for (std::size_t i{0}; i < 6; i++)
+        {
+            ASSERT_EQ(cb.push(Elem(i + 1)), 1);
+        }
+    }
+    // corrupt the fourth item as if its write had been torn
+    int fd{open(tmp.path.c_str(), O_RDWR)};
+    ASSERT_GE(fd, 0);
+    std::size_t slotLen{(Journal::fileLen() - Journal::headerLen) / circBufLen};
+    ASSERT_EQ(pwrite(fd, "\xff", 1, Journal::headerLen + 3 * slotLen), 1);
+    {
+        Journal cb(tmp.path, std::chrono::hours(1));
+        ASSERT_EQ(cb.torn(), 3);
+        ASSERT_EQ(cb.count(), 3);
+        for (std::size_t i{0}; i < 3; i++)
+        {
+            ASSERT_EQ(cb.pop(val), 1);
+            ASSERT_EQ(val, Elem(i + 1));
+        }
+    }
+    // corrupt cursor record 0, which the destructor just flushed the pops to,
+    // so that cursor record 1 is used again
+    ASSERT_EQ(pwrite(fd, "\xff\xff\xff\xff", 4, 24), 4);
+    {
+        Journal cb(tmp.path, std::chrono::hours(1));
+        ASSERT_EQ(cb.count(), 3);
+        ASSERT_EQ(cb.pop(val), 1);
+        ASSERT_EQ(val, Elem(1));
+    }
+    close(fd);
+}
+
+TEST(testJournalCircBuf, lapped)
+{
+    TempPath tmp("lapped");
+    std::array<Elem, circBufLen> in{1, 2, 3, 4, 5, 6, 7, 8};
+    Elem val{0};
+
+    Journal cb(tmp.path, std::chrono::hours(1));
+    ASSERT_EQ(cb.write(in.data(), circBufLen), circBufLen);
+    cb.flush();
+    // reuse the slots of the first two items without flushing
+    ASSERT_EQ(cb.consume(2), 2);
+    ASSERT_EQ(cb.push(Elem(9)), 1);
+    ASSERT_EQ(cb.push(Elem(10)), 1);
+    {
+        // the reused slots are skipped rather than counted as torn
+        Journal other(tmp.path, std::chrono::hours(1));
+        ASSERT_EQ(other.torn(), 0);
+        ASSERT_EQ(other.count(), circBufLen - 2);
+        ASSERT_EQ(other.pop(val), 1);
+        ASSERT_EQ(val, Elem(3));
+    }
+}
+
+TEST(testJournalCircBuf, tornLap)
+{
+    TempPath tmp("tornLap");
+    std::array<Elem, circBufLen> in{1, 2, 3, 4, 5, 6, 7, 8};
+    Elem val{0};
+
+    Journal cb(tmp.path, std::chrono::hours(1));
+    ASSERT_EQ(cb.write(in.data(), circBufLen), circBufLen);
+    cb.flush();
+    // reuse the slot of the first item without flushing
+    ASSERT_EQ(cb.consume(2), 2);
+    ASSERT_EQ(cb.push(Elem(9)), 1);
+    // corrupt the checksum of the reused slot as if its write had been torn
+    int fd{open(tmp.path.c_str(), O_RDWR)};
+    ASSERT_GE(fd, 0);
+    std::size_t slotLen{(Journal::fileLen() - Journal::headerLen) / circBufLen};
+    ASSERT_EQ(pwrite(fd, "\xff", 1, Journal::headerLen + slotLen - 1), 1);
+    close(fd);
+    {
+        // the torn slot held a popped item, so only it is skipped
+        Journal other(tmp.path, std::chrono::hours(1));
+        ASSERT_EQ(other.torn(), 0);
+        ASSERT_EQ(other.count(), circBufLen - 1);
+        ASSERT_EQ(other.pop(val), 1);
+        ASSERT_EQ(val, Elem(2));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,140 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2010    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#include "SeqCircBuf.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <vector>
+#include <cstdint>
+
+using namespace Circular::Copying;
+
+constexpr std::size_t circBufLen{8};
+
+typedef int Elem;
+
+struct TestFullData
+{
+    std::uint64_t start;
+    std::size_t numIter;
+};
+
+TestFullData testFullData
+{
+    .start{0},
+    .numIter{3}
+};
+
+TestFullData test32BitWrapFullData
+{
+    .start{0xfffffffd},
+    .numIter{3}
+};
+
+void testFullFunc(TestFullData* data)
+{
+    SeqCircBuf<Elem, circBufLen> cb(data->start);
+    std::array<Elem, circBufLen> in;
+    std::array<Elem, circBufLen> out;
+    std::uint64_t seq{data->start};
+
+    for (std::size_t i{0}; i < data->numIter; i++)
+    {
+        // every slot is used
+        for (std::size_t j{0}; j < circBufLen; j++)
+        {
+            in[j] = Elem(i * circBufLen + j);
+        }
+        ASSERT_EQ(cb.write(in.data(), circBufLen), circBufLen);
+        ASSERT_EQ(cb.count(), circBufLen);
+        ASSERT_EQ(cb.space(), 0);
+        ASSERT_EQ(cb.push(Elem(0)), 0);
+
+        // the sequence numbers are offsets into the stream
+        ASSERT_EQ(cb.tail(), seq);
+        ASSERT_EQ(cb.head(), seq + circBufLen);
+
+        // leave some items behind so that the next write wraps
+        ASSERT_EQ(cb.read(out.data(), circBufLen - 3), circBufLen - 3);
+        Elem val{0};
+        for (std::size_t j{circBufLen - 3}; j < circBufLen; j++)
+        {
+            ASSERT_EQ(cb.pop(val), 1);
+            out[j] = val;
+        }
+        ASSERT_EQ(out, in);
+        ASSERT_EQ(cb.count(), 0);
+        seq += circBufLen;
+        ASSERT_EQ(cb.write(in.data(), 3), 3);
+        ASSERT_EQ(cb.consume(circBufLen), 3);
+        seq += 3;
+        ASSERT_EQ(cb.tail(), seq);
+    }
+}
+
+struct TestGapData
+{
+    std::uint64_t start;
+    std::size_t numWrite;
+};
+
+TestGapData testGapData
+{
+    .start{100},
+    .numWrite{circBufLen + 5}
+};
+
+TestGapData testLongGapData
+{
+    .start{100},
+    .numWrite{3 * circBufLen + 5}
+};
+
+void testGapFunc(TestGapData* data)
+{
+    SeqCircBuf<Elem, circBufLen> cb(data->start);
+    std::vector<Elem> in(data->numWrite);
+    std::array<Elem, circBufLen> out;
+
+    for (std::size_t i{0}; i < data->numWrite; i++)
+    {
+        in[i] = Elem(i);
+    }
+    // a reader that keeps its own position and has not read anything yet
+    std::uint64_t seq{data->start};
+    ASSERT_EQ(cb.overwrite(in.data(), data->numWrite), data->numWrite);
+    ASSERT_EQ(cb.count(), circBufLen);
+    ASSERT_EQ(cb.head(), data->start + data->numWrite);
+
+    // the oldest items have been discarded
+    ASSERT_THROW(cb.peekAt(seq, out.data(), circBufLen), int);
+    ASSERT_EQ(cb.tail() - seq, data->numWrite - circBufLen);
+
+    // the reader skips the gap and reads the newest items
+    seq = cb.tail();
+    ASSERT_EQ(cb.peekAt(seq, out.data(), circBufLen), circBufLen);
+    for (std::size_t i{0}; i < circBufLen; i++)
+    {
+        ASSERT_EQ(out[i], in[data->numWrite - circBufLen + i]);
+    }
+    ASSERT_EQ(cb.peekAt(seq + 2, out.data(), circBufLen), circBufLen - 2);
+    ASSERT_EQ(out[0], in[data->numWrite - circBufLen + 2]);
+    ASSERT_EQ(cb.peekAt(cb.head(), out.data(), circBufLen), 0);
+    ASSERT_THROW(cb.peekAt(cb.head() + 1, out.data(), circBufLen), int);
+    ASSERT_EQ(cb.count(), circBufLen);
+}
+
+TEST(testSeqCircBuf, full) {testFullFunc(&testFullData);}
+TEST(testSeqCircBuf, full32BitWrap) {testFullFunc(&test32BitWrapFullData);}
+TEST(testSeqCircBuf, gap) {testGapFunc(&testGapData);}
+TEST(testSeqCircBuf, longGap) {testGapFunc(&testLongGapData);}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
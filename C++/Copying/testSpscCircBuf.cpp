@@ -0,0 +1,227 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#include "SpscCircBuf.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <thread>
+
+using namespace Circular::Copying;
+
+constexpr std::size_t circBufLen{8};
+constexpr std::size_t maxNumIter{(circBufLen + circBufLen / 2)};
+
+typedef int Elem;
+
+struct TestPushPopData
+{
+    std::size_t numIter;
+    std::array<std::size_t, maxNumIter> expectedPushNum;
+    std::array<std::size_t, maxNumIter> expectedPopNum;
+};
+
+TestPushPopData testPushPopData
+{
+    .numIter{maxNumIter},
+    .expectedPushNum{1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0},
+    .expectedPopNum{1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0}
+};
+
+void testPushPopFunc(TestPushPopData* data)
+{
+    SpscCircBuf<Elem, circBufLen> cb;
+
+    for (std::size_t i{0}; i < data->numIter; i++)
+    {
+        std::size_t num{cb.push(Elem(i + 1))};
+        ASSERT_EQ(num, data->expectedPushNum.at(i));
+    }
+    ASSERT_EQ(cb.count(), circBufLen - 1);
+    ASSERT_EQ(cb.space(), 0);
+    for (std::size_t i{0}; i < data->numIter; i++)
+    {
+        Elem val{0};
+        std::size_t num{cb.pop(val)};
+        ASSERT_EQ(num, data->expectedPopNum.at(i));
+        ASSERT_EQ(val, num == 0 ? 0 : Elem(i + 1));
+    }
+    ASSERT_EQ(cb.count(), 0);
+    ASSERT_EQ(cb.space(), circBufLen - 1);
+}
+
+struct TestReadWriteData
+{
+    std::array<const Elem, circBufLen> str;
+    std::size_t strLen;
+    std::size_t numIter;
+    std::array<std::size_t, maxNumIter> expectedWriteNum;
+    std::array<std::size_t, maxNumIter> expectedReadNum;
+};
+
+TestReadWriteData testReadWriteData
+{
+    .str{1, 2, 3, 4, 5},
+    .strLen{5},
+    .numIter{4},
+    .expectedWriteNum{5, 5, 5, 5},
+    .expectedReadNum{5, 5, 5, 5}
+};
+
+TestReadWriteData testReadWriteOverflowData
+{
+    .str{1, 2, 3, 4, 5, 6, 7, 8},
+    .strLen{8},
+    .numIter{4},
+    .expectedWriteNum{7, 7, 7, 7},
+    .expectedReadNum{7, 7, 7, 7}
+};
+
+void testReadWriteFunc(TestReadWriteData* data)
+{
+    SpscCircBuf<Elem, circBufLen> cb;
+
+    // each iteration starts at a different offset so that the data wraps
+    for (std::size_t i{0}; i < data->numIter; i++)
+    {
+        std::size_t num{cb.write(data->str.data(), data->strLen)};
+        ASSERT_EQ(num, data->expectedWriteNum.at(i));
+        Elem buf[circBufLen]{};
+        num = cb.read(buf, circBufLen);
+        ASSERT_EQ(num, data->expectedReadNum.at(i));
+        for (std::size_t j{0}; j < num; j++)
+        {
+            ASSERT_EQ(buf[j], data->str.at(j));
+        }
+        ASSERT_EQ(cb.count(), 0);
+    }
+}
+
+struct TestPeekConsumeData
+{
+    std::array<const Elem, circBufLen> str;
+    std::size_t strLen;
+    std::size_t len;
+    std::size_t numIter;
+    std::array<std::size_t, maxNumIter> expectedNum;
+};
+
+TestPeekConsumeData testPeekConsumeData
+{
+    .str{1, 2, 3, 4, 5, 6, 7},
+    .strLen{7},
+    .len{3},
+    .numIter{4},
+    .expectedNum{3, 3, 1, 0}
+};
+
+void testPeekConsumeFunc(TestPeekConsumeData* data)
+{
+    SpscCircBuf<Elem, circBufLen> cb;
+    std::size_t offset{0};
+
+    // move the indices away from zero so that the data wraps
+    Elem tmp[circBufLen / 2]{};
+    cb.write(tmp, circBufLen / 2);
+    cb.read(tmp, circBufLen / 2);
+    cb.write(data->str.data(), data->strLen);
+    for (std::size_t i{0}; i < data->numIter; i++)
+    {
+        for (std::size_t j{0}; j < 2; j++)
+        {
+            Elem buf[circBufLen]{};
+            std::size_t num{cb.peek(buf, data->len)};
+            ASSERT_EQ(num, data->expectedNum.at(i));
+            for (std::size_t k{0}; k < num; k++)
+            {
+                ASSERT_EQ(buf[k], data->str.at(offset + k));
+            }
+        }
+        std::size_t num{cb.consume(data->len)};
+        ASSERT_EQ(num, data->expectedNum.at(i));
+        offset += num;
+    }
+}
+
+struct TestMultithreadedData
+{
+    std::size_t numElem;
+    std::size_t chunkLen;
+};
+
+TestMultithreadedData testMultithreadedData
+{
+    .numElem{1000000},
+    .chunkLen{1}
+};
+
+TestMultithreadedData testMultithreadedChunkData
+{
+    .numElem{1000000},
+    .chunkLen{5}
+};
+
+void testMultithreadedFunc(TestMultithreadedData* data)
+{
+    SpscCircBuf<Elem, circBufLen> cb;
+
+    std::thread consumer([&cb, data]()
+                    {
+                        Elem expected{0};
+                        while (std::size_t(expected) < data->numElem)
+                        {
+                            Elem buf[circBufLen]{};
+                            std::size_t num{data->chunkLen == 1 ? cb.pop(buf[0]) : cb.read(buf, data->chunkLen)};
+                            if (num == 0)
+                            {
+                                std::this_thread::yield();
+                            }
+                            for (std::size_t i{0}; i < num; i++)
+                            {
+                                ASSERT_EQ(buf[i], expected++);
+                            }
+                        }
+                    });
+    std::thread producer([&cb, data]()
+                    {
+                        Elem next{0};
+                        while (std::size_t(next) < data->numElem)
+                        {
+                            Elem buf[circBufLen]{};
+                            std::size_t len{data->chunkLen};
+                            if (data->numElem - next < len)
+                            {
+                                len = data->numElem - next;
+                            }
+                            for (std::size_t i{0}; i < len; i++)
+                            {
+                                buf[i] = next + Elem(i);
+                            }
+                            std::size_t num{len == 1 ? cb.push(buf[0]) : cb.write(buf, len)};
+                            if (num == 0)
+                            {
+                                std::this_thread::yield();
+                            }
+                            next += Elem(num);
+                        }
+                    });
+    producer.join();
+    consumer.join();
+    ASSERT_EQ(cb.count(), 0);
+}
+
+TEST(testSpscCircBuf, pushPop) {testPushPopFunc(&testPushPopData);}
+TEST(testSpscCircBuf, readWrite) {testReadWriteFunc(&testReadWriteData);}
+TEST(testSpscCircBuf, readWriteOverflow) {testReadWriteFunc(&testReadWriteOverflowData);}
+TEST(testSpscCircBuf, peekConsume) {testPeekConsumeFunc(&testPeekConsumeData);}
+TEST(testSpscCircBuf, multithreaded) {testMultithreadedFunc(&testMultithreadedData);}
+TEST(testSpscCircBuf, multithreadedChunk) {testMultithreadedFunc(&testMultithreadedChunkData);}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,193 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2010    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#include "VarCircBuf.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <memory_resource>
+#include <string>
+#include <utility>
+
+using namespace Circular::Copying;
+
+constexpr std::size_t circBufLen{8};
+
+typedef int Elem;
+
+TEST(testVarCircBuf, invalid)
+{
+    ASSERT_THROW((VarCircBuf<Elem>(0)), int);
+    ASSERT_THROW((VarCircBuf<Elem>(circBufLen + 1)), int);
+}
+
+TEST(testVarCircBuf, pushPop)
+{
+    VarCircBuf<Elem> cb(circBufLen);
+
+    ASSERT_EQ(cb.len(), circBufLen);
+    for (std::size_t i{0}; i < circBufLen; i++)
+    {
+        ASSERT_EQ(cb.push(Elem(i + 1)), i < circBufLen - 1 ? 1 : 0);
+    }
+    ASSERT_EQ(cb.count(), circBufLen - 1);
+    ASSERT_EQ(cb.space(), 0);
+    for (std::size_t i{0}; i < circBufLen - 1; i++)
+    {
+        Elem val{0};
+        ASSERT_EQ(cb.pop(val), 1);
+        ASSERT_EQ(val, Elem(i + 1));
+    }
+    Elem val{0};
+    ASSERT_EQ(cb.pop(val), 0);
+}
+
+TEST(testVarCircBuf, readWrite)
+{
+    VarCircBuf<Elem> cb(circBufLen);
+    std::array<Elem, circBufLen> in{1, 2, 3, 4, 5, 6, 7, 8};
+    std::array<Elem, circBufLen> out{};
+
+    for (std::size_t i{0}; i < 3; i++)
+    {
+        ASSERT_EQ(cb.write(in.data(), 5), 5);
+        ASSERT_EQ(cb.peek(out.data(), out.size()), 5);
+        auto spans{cb.readableSpans()};
+        ASSERT_EQ(spans.first.size() + spans.second.size(), 5);
+        ASSERT_EQ(cb.read(out.data(), out.size()), 5);
+        for (std::size_t j{0}; j < 5; j++)
+        {
+            ASSERT_EQ(out[j], in[j]);
+        }
+    }
+    ASSERT_EQ(cb.write(in.data(), in.size()), circBufLen - 1);
+    ASSERT_EQ(cb.consume(in.size()), circBufLen - 1);
+}
+
+TEST(testVarCircBuf, copyMove)
+{
+    VarCircBuf<std::string> cb1(circBufLen);
+    std::string val;
+
+    ASSERT_EQ(cb1.push("one"), 1);
+    ASSERT_EQ(cb1.push("two"), 1);
+    VarCircBuf<std::string> cb2(cb1);
+    ASSERT_EQ(cb2.pop(val), 1);
+    ASSERT_EQ(val, "one");
+    ASSERT_EQ(cb1.count(), 2);
+
+    // moving transfers the buffer
+    std::string* buf{cb1.buf().data()};
+    VarCircBuf<std::string> cb3(std::move(cb1));
+    ASSERT_EQ(cb3.buf().data(), buf);
+    ASSERT_EQ(cb3.count(), 2);
+    ASSERT_EQ(cb1.len(), 0);
+    ASSERT_EQ(cb1.count(), 0);
+    ASSERT_EQ(cb1.space(), 0);
+    ASSERT_EQ(cb1.push("three"), 0);
+
+    // assigning a buffer of a different length
+    VarCircBuf<std::string> cb4(2 * circBufLen);
+    cb4 = cb3;
+    ASSERT_EQ(cb4.len(), circBufLen);
+    ASSERT_EQ(cb4.count(), 2);
+    cb1 = std::move(cb4);
+    ASSERT_EQ(cb1.len(), circBufLen);
+    ASSERT_EQ(cb1.pop(val), 1);
+    ASSERT_EQ(val, "one");
+}
+
+TEST(testVarCircBuf, pmr)
+{
+    std::array<std::byte, 4096> arena1{};
+    std::array<std::byte, 4096> arena2{};
+    std::pmr::monotonic_buffer_resource res1(arena1.data(), arena1.size(), std::pmr::null_memory_resource());
+    std::pmr::monotonic_buffer_resource res2(arena2.data(), arena2.size(), std::pmr::null_memory_resource());
+    pmr::VarCircBuf<Elem> cb1(circBufLen, &res1);
+    pmr::VarCircBuf<Elem> cb2(circBufLen, &res2);
+    Elem val{0};
+
+    auto inArena = [](const Elem* p, const std::array<std::byte, 4096>& arena)
+    {
+        return reinterpret_cast<const std::byte*>(p) >= arena.data()
+            && reinterpret_cast<const std::byte*>(p) < arena.data() + arena.size();
+    };
+    ASSERT_TRUE(inArena(cb1.buf().data(), arena1));
+    ASSERT_TRUE(inArena(cb2.buf().data(), arena2));
+    ASSERT_EQ(cb1.push(42), 1);
+
+    // the allocators differ and do not propagate, so the items are moved
+    cb2 = std::move(cb1);
+    ASSERT_EQ(cb2.get_allocator().resource(), &res2);
+    ASSERT_TRUE(inArena(cb2.buf().data(), arena2));
+    ASSERT_EQ(cb2.pop(val), 1);
+    ASSERT_EQ(val, 42);
+    ASSERT_EQ(cb1.count(), 0);
+    ASSERT_EQ(cb1.len(), 0);
+
+    // a copy keeps the default resource rather than the arena
+    pmr::VarCircBuf<Elem> cb3(cb2);
+    ASSERT_EQ(cb3.get_allocator().resource(), std::pmr::get_default_resource());
+
+    // larger than the arena
+    ASSERT_THROW((pmr::VarCircBuf<Elem>(4096, &res1)), std::bad_alloc);
+}
+
+TEST(testVarCircBuf, swap)
+{
+    std::array<std::byte, 4096> arena1{};
+    std::array<std::byte, 4096> arena2{};
+    std::pmr::monotonic_buffer_resource res1(arena1.data(), arena1.size(), std::pmr::null_memory_resource());
+    std::pmr::monotonic_buffer_resource res2(arena2.data(), arena2.size(), std::pmr::null_memory_resource());
+    VarCircBuf<Elem> cb1(circBufLen);
+    VarCircBuf<Elem> cb2(2 * circBufLen);
+    pmr::VarCircBuf<Elem> cb3(circBufLen, &res1);
+    pmr::VarCircBuf<Elem> cb4(2 * circBufLen, &res2);
+    Elem val{0};
+
+    auto inArena = [](const Elem* p, const std::array<std::byte, 4096>& arena)
+    {
+        return reinterpret_cast<const std::byte*>(p) >= arena.data()
+            && reinterpret_cast<const std::byte*>(p) < arena.data() + arena.size();
+    };
+
+    // the allocators are equal, so the buffers are exchanged
+    ASSERT_EQ(cb1.push(1), 1);
+    Elem* buf1{cb1.buf().data()};
+    Elem* buf2{cb2.buf().data()};
+    swap(cb1, cb2);
+    ASSERT_EQ(cb1.buf().data(), buf2);
+    ASSERT_EQ(cb1.len(), 2 * circBufLen);
+    ASSERT_EQ(cb1.count(), 0);
+    ASSERT_EQ(cb2.buf().data(), buf1);
+    ASSERT_EQ(cb2.pop(val), 1);
+    ASSERT_EQ(val, 1);
+
+    // the allocators differ and do not propagate, so the items are moved
+    // and each circular buffer keeps its allocator
+    ASSERT_EQ(cb3.push(3), 1);
+    ASSERT_EQ(cb4.push(4), 1);
+    ASSERT_EQ(cb4.push(5), 1);
+    swap(cb3, cb4);
+    ASSERT_EQ(cb3.get_allocator().resource(), &res1);
+    ASSERT_TRUE(inArena(cb3.buf().data(), arena1));
+    ASSERT_EQ(cb3.len(), 2 * circBufLen);
+    ASSERT_EQ(cb3.count(), 2);
+    ASSERT_EQ(cb3.pop(val), 1);
+    ASSERT_EQ(val, 4);
+    ASSERT_EQ(cb4.get_allocator().resource(), &res2);
+    ASSERT_TRUE(inArena(cb4.buf().data(), arena2));
+    ASSERT_EQ(cb4.len(), circBufLen);
+    ASSERT_EQ(cb4.count(), 1);
+    ASSERT_EQ(cb4.pop(val), 1);
+    ASSERT_EQ(val, 3);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -10,24 +10,28 @@
 
 #include <iostream>
 #include <array>
+#include <span>
+#include <utility>
+#include <type_traits>
+#include "HeapArray.h"
 
 namespace Circular
 {
 namespace Moving
 {
 
-template<typename T, std::size_t N>
+template<typename T, std::size_t N, typename S = std::array<T, N>>
 class CircBuf;
 
-template<typename T, std::size_t N>
-std::ostream& operator<<(std::ostream&, CircBuf<T, N>&);
+template<typename T, std::size_t N, typename S>
+std::ostream& operator<<(std::ostream&, CircBuf<T, N, S>&);
 
-template<typename T, std::size_t N>
+template<typename T, std::size_t N, typename S>
 class CircBuf
 {
     static constexpr bool power_of_2(std::size_t i) {return (i > 0) && ((i & (i - 1)) == 0);}
     static_assert(power_of_2(N), "N must be an integer power of 2");
-    friend std::ostream& operator<< <T, N>(std::ostream&, CircBuf&);
+    friend std::ostream& operator<< <T, N, S>(std::ostream&, CircBuf&);
 public:
     CircBuf() = default;
     CircBuf(const CircBuf&) = delete;
@@ -40,7 +44,7 @@ public:
     std::size_t tail() const;
     void tail(std::size_t);
     std::size_t len() const;
-    std::array<T, N>& buf();
+    S& buf();
     std::size_t countToEnd() const;
     std::size_t spaceToEnd() const;
     std::size_t count() const;
@@ -49,12 +53,17 @@ public:
     std::size_t push(T&&);
     std::size_t read(T*, std::size_t);
     std::size_t write(T*, std::size_t);
+    std::pair<std::span<T>, std::span<T>> reserve(std::size_t);
+    std::size_t commit(std::size_t);
 protected:
     std::size_t _head{0};
     std::size_t _tail{0};
-    std::array<T, N> _buf{};
+    S _buf{};
 };
 
+template<typename T, std::size_t N>
+using HeapCircBuf = CircBuf<T, N, HeapArray<T, N>>;
+
 #include "CircBuf.hpp"
 
 }  // namespace Moving
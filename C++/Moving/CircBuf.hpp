@@ -17,11 +17,22 @@
 //
 // When the head index is equal to the tail index, the circular buffer is empty.
 // When the head index is one less than the tail index, the circular buffer is full.
+//
+// reserve and commit let a producer construct items in place instead of moving
+// them in with write. reserve returns the free space at the head as up to two
+// spans, the second of which starts at the beginning of the linear buffer, and
+// commit then adds the first items of those spans to the circular buffer.
+//
+// The items are stored in S, which by default is an array inside the circular
+// buffer, so moving the circular buffer moves every item. HeapCircBuf stores them
+// in a HeapArray instead, so that moving the circular buffer only moves a pointer.
+// A HeapCircBuf that has been moved from has no storage, so its length and space
+// are 0 and nothing can be added to it until it is assigned to.
 
 #include <utility>
 
-template<typename T, std::size_t N>
-std::ostream& operator<<(std::ostream& ostr, CircBuf<T, N>& cb)
+template<typename T, std::size_t N, typename S>
+std::ostream& operator<<(std::ostream& ostr, CircBuf<T, N, S>& cb)
 {
     std::size_t i{cb._tail};
 
@@ -38,55 +49,70 @@ std::ostream& operator<<(std::ostream& ostr, CircBuf<T, N>& cb)
     return ostr;
 }
 
-template<typename T, std::size_t N>
-CircBuf<T, N>::CircBuf(CircBuf&& cb)
+template<typename T, std::size_t N, typename S>
+CircBuf<T, N, S>::CircBuf(CircBuf&& cb) : _head{cb._head}, _tail{cb._tail}, _buf{std::move(cb._buf)}
 {
-    std::swap(_head, cb._head);
-    std::swap(_tail, cb._tail);
-    std::swap(_buf, cb._buf);
+    cb._head = 0;
+    cb._tail = 0;
+    if constexpr (std::is_same_v<S, std::array<T, N>>)
+    {
+        // leave the items as they would be in a new circular buffer
+        cb._buf = S{};
+    }
 }
 
-template<typename T, std::size_t N>
-CircBuf<T, N>& CircBuf<T, N>::operator=(CircBuf&& cb)
+template<typename T, std::size_t N, typename S>
+CircBuf<T, N, S>& CircBuf<T, N, S>::operator=(CircBuf&& cb)
 {
-    std::swap(_head, cb._head);
-    std::swap(_tail, cb._tail);
-    std::swap(_buf, cb._buf);
+    if (this == &cb)
+    {
+        return *this;
+    }
+    _head = cb._head;
+    _tail = cb._tail;
+    _buf = std::move(cb._buf);
+    cb._head = 0;
+    cb._tail = 0;
+    if constexpr (std::is_same_v<S, std::array<T, N>>)
+    {
+        // leave the items as they would be in a new circular buffer
+        cb._buf = S{};
+    }
     return *this;
 }
 
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::head() const
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::head() const
 {
     return _head;
 }
 
-template<typename T, std::size_t N>
-void CircBuf<T, N>::head(std::size_t i)
+template<typename T, std::size_t N, typename S>
+void CircBuf<T, N, S>::head(std::size_t i)
 {
     _head = i;
 }
 
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::tail() const
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::tail() const
 {
     return _tail;
 }
 
-template<typename T, std::size_t N>
-void CircBuf<T, N>::tail(std::size_t i)
+template<typename T, std::size_t N, typename S>
+void CircBuf<T, N, S>::tail(std::size_t i)
 {
     _tail = i;
 }
 
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::len() const
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::len() const
 {
-    return N;
+    return _buf.size();
 }
 
-template<typename T, std::size_t N>
-std::array<T, N>& CircBuf<T, N>::buf()
+template<typename T, std::size_t N, typename S>
+S& CircBuf<T, N, S>::buf()
 {
     return _buf;
 }
@@ -94,8 +120,8 @@ std::array<T, N>& CircBuf<T, N>::buf()
 // number of bytes present up to the end of the linear buffer or
 // the end of the circular buffer, whichever is smaller
 // this special version (with an argument) is required by CircBuf::peek()
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::countToEnd() const
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::countToEnd() const
 {
     std::size_t countEndLinearBuf{N - _tail};
     std::size_t countEndCircBuf{(_head + countEndLinearBuf) & (N - 1)};
@@ -104,31 +130,39 @@ std::size_t CircBuf<T, N>::countToEnd() const
 
 // space available to the end of the linear buffer or
 // the end of the circular buffer, whichever is smaller
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::spaceToEnd() const
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::spaceToEnd() const
 {
+    if (_buf.size() == 0)
+    {
+        return 0;
+    }
     std::size_t spaceEndLinearBuf{N - _head};
     std::size_t spaceEndCircBuf{(_tail + spaceEndLinearBuf - 1) & (N - 1)};
     return spaceEndLinearBuf < spaceEndCircBuf ? spaceEndLinearBuf : spaceEndCircBuf;
 }
 
 // total number of items present in the circular buffer
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::count() const
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::count() const
 {
     return (_head - _tail) & (N - 1);
 }
 
 // total space available for items in the circular buffer
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::space() const
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::space() const
 {
+    if (_buf.size() == 0)
+    {
+        return 0;
+    }
     return (_tail - _head - 1) & (N - 1);
 }
 
 // returns number of items popped
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::pop(T&& val)
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::pop(T&& val)
 {
     if (count() == 0)
     {
@@ -140,8 +174,8 @@ std::size_t CircBuf<T, N>::pop(T&& val)
 }
 
 // returns number of items pushed
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::push(T&& val)
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::push(T&& val)
 {
     if (space() == 0)
     {
@@ -153,8 +187,8 @@ std::size_t CircBuf<T, N>::push(T&& val)
 }
 
 // returns number of items read
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::read(T* buf, std::size_t len)
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::read(T* buf, std::size_t len)
 {
     std::size_t ret{0};
 
@@ -181,8 +215,8 @@ std::size_t CircBuf<T, N>::read(T* buf, std::size_t len)
 }
 
 // returns number of items written
-template<typename T, std::size_t N>
-std::size_t CircBuf<T, N>::write(T* buf, std::size_t len)
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::write(T* buf, std::size_t len)
 {
     std::size_t ret{0};
 
@@ -207,3 +241,38 @@ std::size_t CircBuf<T, N>::write(T* buf, std::size_t len)
     }
     return ret;
 }
+
+// reserve space for up to len items at the head without adding them
+// returns the space before and after the end of the linear buffer
+// (the second span is empty unless the space wraps)
+template<typename T, std::size_t N, typename S>
+std::pair<std::span<T>, std::span<T>> CircBuf<T, N, S>::reserve(std::size_t len)
+{
+    std::size_t num{space()};
+
+    if (len < num)
+    {
+        num = len;
+    }
+    std::size_t first{spaceToEnd()};
+    if (num < first)
+    {
+        first = num;
+    }
+    return {std::span<T>(_buf.data() + _head, first), std::span<T>(_buf.data(), num - first)};
+}
+
+// add the first len items of the reserved space to the circular buffer
+// returns number of items added
+template<typename T, std::size_t N, typename S>
+std::size_t CircBuf<T, N, S>::commit(std::size_t len)
+{
+    std::size_t num{space()};
+
+    if (len < num)
+    {
+        num = len;
+    }
+    _head = (_head + num) & (N - 1);
+    return num;
+}
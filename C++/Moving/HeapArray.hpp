@@ -0,0 +1,122 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+// A fixed length array that is allocated on the heap, for use as the storage of
+// a circular buffer.
+//
+// Copying an array copies its items, but moving an array only moves the pointer
+// to them, so moving a circular buffer that uses it takes the same time whatever
+// its length.
+//
+// A moved from array is empty: size is 0 and data, begin and end are null, so
+// the circular buffer left behind by a move has no space until it is assigned
+// to. The items of an empty array must not be accessed.
+
+template<typename T, std::size_t N>
+HeapArray<T, N>::HeapArray() : _arr{std::make_unique<std::array<T, N>>()} {}
+
+template<typename T, std::size_t N>
+HeapArray<T, N>::HeapArray(const HeapArray& arr) :
+    _arr{arr._arr ? std::make_unique<std::array<T, N>>(*arr._arr) : nullptr} {}
+
+template<typename T, std::size_t N>
+HeapArray<T, N>::HeapArray(HeapArray&& arr) noexcept : _arr{std::move(arr._arr)} {}
+
+template<typename T, std::size_t N>
+HeapArray<T, N>& HeapArray<T, N>::operator=(const HeapArray& arr)
+{
+    if (this == &arr)
+    {
+        return *this;
+    }
+    if (!arr._arr)
+    {
+        _arr.reset();
+    }
+    else if (_arr)
+    {
+        *_arr = *arr._arr;
+    }
+    else
+    {
+        _arr = std::make_unique<std::array<T, N>>(*arr._arr);
+    }
+    return *this;
+}
+
+template<typename T, std::size_t N>
+HeapArray<T, N>& HeapArray<T, N>::operator=(HeapArray&& arr) noexcept
+{
+    _arr = std::move(arr._arr);
+    return *this;
+}
+
+template<typename T, std::size_t N>
+T& HeapArray<T, N>::operator[](std::size_t i)
+{
+    return (*_arr)[i];
+}
+
+template<typename T, std::size_t N>
+const T& HeapArray<T, N>::operator[](std::size_t i) const
+{
+    return (*_arr)[i];
+}
+
+template<typename T, std::size_t N>
+T& HeapArray<T, N>::at(std::size_t i)
+{
+    return _arr->at(i);
+}
+
+template<typename T, std::size_t N>
+const T& HeapArray<T, N>::at(std::size_t i) const
+{
+    return _arr->at(i);
+}
+
+template<typename T, std::size_t N>
+T* HeapArray<T, N>::data()
+{
+    return _arr ? _arr->data() : nullptr;
+}
+
+template<typename T, std::size_t N>
+const T* HeapArray<T, N>::data() const
+{
+    return _arr ? _arr->data() : nullptr;
+}
+
+template<typename T, std::size_t N>
+T* HeapArray<T, N>::begin()
+{
+    return _arr ? _arr->data() : nullptr;
+}
+
+template<typename T, std::size_t N>
+const T* HeapArray<T, N>::begin() const
+{
+    return _arr ? _arr->data() : nullptr;
+}
+
+template<typename T, std::size_t N>
+T* HeapArray<T, N>::end()
+{
+    return _arr ? _arr->data() + N : nullptr;
+}
+
+template<typename T, std::size_t N>
+const T* HeapArray<T, N>::end() const
+{
+    return _arr ? _arr->data() + N : nullptr;
+}
+
+template<typename T, std::size_t N>
+std::size_t HeapArray<T, N>::size() const
+{
+    return _arr ? N : 0;
+}
@@ -0,0 +1,64 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#ifndef MPMC_CIRC_BUF_H
+#define MPMC_CIRC_BUF_H
+
+#include <iostream>
+#include <array>
+#include <atomic>
+#include <utility>
+
+namespace Circular
+{
+namespace Moving
+{
+
+template<typename T, std::size_t N>
+class MpmcCircBuf;
+
+template<typename T, std::size_t N>
+std::ostream& operator<<(std::ostream&, MpmcCircBuf<T, N>&);
+
+template<typename T, std::size_t N>
+class MpmcCircBuf final
+{
+    static constexpr bool power_of_2(std::size_t i) {return (i > 0) && ((i & (i - 1)) == 0);}
+    static_assert(power_of_2(N), "N must be an integer power of 2");
+    static constexpr std::size_t cacheLineLen{64};
+    friend std::ostream& operator<< <T, N>(std::ostream&, MpmcCircBuf&);
+    struct alignas(cacheLineLen) Slot
+    {
+        std::atomic<std::size_t> seq;
+        T val;
+    };
+public:
+    MpmcCircBuf();
+    MpmcCircBuf(const MpmcCircBuf&) = delete;
+    MpmcCircBuf(MpmcCircBuf&&) = delete;
+    ~MpmcCircBuf() = default;
+    MpmcCircBuf& operator=(const MpmcCircBuf&) = delete;
+    MpmcCircBuf& operator=(MpmcCircBuf&&) = delete;
+    std::size_t len() const;
+    std::size_t count() const;
+    std::size_t space() const;
+    std::size_t pop(T&&);
+    std::size_t push(T&&);
+    std::size_t read(T*, std::size_t);
+    std::size_t write(T*, std::size_t);
+protected:
+    alignas(cacheLineLen) std::atomic<std::size_t> _head{0};
+    alignas(cacheLineLen) std::atomic<std::size_t> _tail{0};
+    std::array<Slot, N> _buf;
+};
+
+#include "MpmcCircBuf.hpp"
+
+}  // namespace Moving
+}  // namespace Circular
+
+#endif
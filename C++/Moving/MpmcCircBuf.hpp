@@ -0,0 +1,243 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+// A multiple producer, multiple consumer queue implemented using a contiguous
+// buffer of slots, each of which carries a sequence number.
+//
+// Elements are moved in to and out of the buffer.
+//
+// The head and tail are free running positions that are masked to find a slot.
+// A producer claims the slot at the head position by advancing the head with a
+// compare and swap, moves the element in, and then publishes the slot by setting
+// its sequence number to the position plus one. A consumer claims the slot at the
+// tail position in the same way once its sequence number is the position plus one,
+// moves the element out, and then releases the slot to the producer that will
+// claim it on the next lap by setting its sequence number to the position plus N.
+//
+// A slot whose sequence number is behind the position being claimed is still in
+// use by the previous lap, so the circular buffer is full (producer) or empty
+// (consumer). Unlike the single threaded circular buffer, all N slots are usable.
+//
+// read and write claim a run of consecutive slots with a single compare and swap
+// and then publish each slot in turn.
+//
+// Each slot, the head and the tail live on separate cache lines.
+//
+// The circular buffer has no virtual members, so that it can be placed in
+// memory shared between processes that map it at different addresses.
+
+template<typename T, std::size_t N>
+std::ostream& operator<<(std::ostream& ostr, MpmcCircBuf<T, N>& cb)
+{
+    std::size_t i{cb._tail.load(std::memory_order_acquire)};
+    std::size_t head{cb._head.load(std::memory_order_acquire)};
+
+    ostr << "{";
+    while (i != head)
+    {
+        ostr << ' ' <<  cb._buf[i & (N - 1)].val;
+        i++;
+    }
+    ostr << " }";
+    return ostr;
+}
+
+template<typename T, std::size_t N>
+MpmcCircBuf<T, N>::MpmcCircBuf()
+{
+    for (std::size_t i{0}; i < N; i++)
+    {
+        _buf[i].seq.store(i, std::memory_order_relaxed);
+    }
+}
+
+template<typename T, std::size_t N>
+std::size_t MpmcCircBuf<T, N>::len() const
+{
+    return N;
+}
+
+// total number of items present in the circular buffer
+// (only a snapshot when other threads are pushing or popping)
+template<typename T, std::size_t N>
+std::size_t MpmcCircBuf<T, N>::count() const
+{
+    std::size_t tail{_tail.load(std::memory_order_acquire)};
+    std::size_t head{_head.load(std::memory_order_acquire)};
+    std::size_t num{head - tail};
+    return num < N ? num : N;
+}
+
+// total space available for items in the circular buffer
+// (only a snapshot when other threads are pushing or popping)
+template<typename T, std::size_t N>
+std::size_t MpmcCircBuf<T, N>::space() const
+{
+    return N - count();
+}
+
+// returns number of items popped
+template<typename T, std::size_t N>
+std::size_t MpmcCircBuf<T, N>::pop(T&& val)
+{
+    std::size_t pos{_tail.load(std::memory_order_relaxed)};
+    Slot* slot{nullptr};
+
+    for (;;)
+    {
+        slot = &_buf[pos & (N - 1)];
+        std::size_t seq{slot->seq.load(std::memory_order_acquire)};
+        std::ptrdiff_t diff{std::ptrdiff_t(seq - (pos + 1))};
+        if (diff == 0)
+        {
+            if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            return 0;
+        }
+        else
+        {
+            pos = _tail.load(std::memory_order_relaxed);
+        }
+    }
+    val = std::move(slot->val);
+    slot->seq.store(pos + N, std::memory_order_release);
+    return 1;
+}
+
+// returns number of items pushed
+template<typename T, std::size_t N>
+std::size_t MpmcCircBuf<T, N>::push(T&& val)
+{
+    std::size_t pos{_head.load(std::memory_order_relaxed)};
+    Slot* slot{nullptr};
+
+    for (;;)
+    {
+        slot = &_buf[pos & (N - 1)];
+        std::size_t seq{slot->seq.load(std::memory_order_acquire)};
+        std::ptrdiff_t diff{std::ptrdiff_t(seq - pos)};
+        if (diff == 0)
+        {
+            if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            return 0;
+        }
+        else
+        {
+            pos = _head.load(std::memory_order_relaxed);
+        }
+    }
+    slot->val = std::move(val);
+    slot->seq.store(pos + 1, std::memory_order_release);
+    return 1;
+}
+
+// returns number of items read
+template<typename T, std::size_t N>
+std::size_t MpmcCircBuf<T, N>::read(T* buf, std::size_t len)
+{
+    std::size_t pos{_tail.load(std::memory_order_relaxed)};
+    std::size_t num{0};
+
+    if (len > N)
+    {
+        len = N;
+    }
+    for (;;)
+    {
+        std::ptrdiff_t diff{0};
+        for (num = 0; num < len; num++)
+        {
+            std::size_t seq{_buf[(pos + num) & (N - 1)].seq.load(std::memory_order_acquire)};
+            diff = std::ptrdiff_t(seq - (pos + num + 1));
+            if (diff != 0)
+            {
+                break;
+            }
+        }
+        if (num > 0)
+        {
+            if (_tail.compare_exchange_weak(pos, pos + num, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            return 0;
+        }
+        else
+        {
+            pos = _tail.load(std::memory_order_relaxed);
+        }
+    }
+    for (std::size_t i{0}; i < num; i++)
+    {
+        Slot& slot{_buf[(pos + i) & (N - 1)]};
+        *buf++ = std::move(slot.val);
+        slot.seq.store(pos + i + N, std::memory_order_release);
+    }
+    return num;
+}
+
+// returns number of items written
+template<typename T, std::size_t N>
+std::size_t MpmcCircBuf<T, N>::write(T* buf, std::size_t len)
+{
+    std::size_t pos{_head.load(std::memory_order_relaxed)};
+    std::size_t num{0};
+
+    if (len > N)
+    {
+        len = N;
+    }
+    for (;;)
+    {
+        std::ptrdiff_t diff{0};
+        for (num = 0; num < len; num++)
+        {
+            std::size_t seq{_buf[(pos + num) & (N - 1)].seq.load(std::memory_order_acquire)};
+            diff = std::ptrdiff_t(seq - (pos + num));
+            if (diff != 0)
+            {
+                break;
+            }
+        }
+        if (num > 0)
+        {
+            if (_head.compare_exchange_weak(pos, pos + num, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            return 0;
+        }
+        else
+        {
+            pos = _head.load(std::memory_order_relaxed);
+        }
+    }
+    for (std::size_t i{0}; i < num; i++)
+    {
+        Slot& slot{_buf[(pos + i) & (N - 1)]};
+        slot.val = std::move(*buf++);
+        slot.seq.store(pos + i + 1, std::memory_order_release);
+    }
+    return num;
+}
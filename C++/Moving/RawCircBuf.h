@@ -0,0 +1,70 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#ifndef RAW_CIRC_BUF_H
+#define RAW_CIRC_BUF_H
+
+#include <iostream>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace Circular
+{
+namespace Moving
+{
+
+template<typename T, std::size_t N>
+class RawCircBuf;
+
+template<typename T, std::size_t N>
+std::ostream& operator<<(std::ostream&, RawCircBuf<T, N>&);
+
+template<typename T, std::size_t N>
+class RawCircBuf
+{
+    static constexpr bool power_of_2(std::size_t i) {return (i > 0) && ((i & (i - 1)) == 0);}
+    static_assert(power_of_2(N), "N must be an integer power of 2");
+    friend std::ostream& operator<< <T, N>(std::ostream&, RawCircBuf&);
+public:
+    RawCircBuf() = default;
+    RawCircBuf(const RawCircBuf&) = delete;
+    RawCircBuf(RawCircBuf&&);
+    virtual ~RawCircBuf();
+    RawCircBuf& operator=(const RawCircBuf&) = delete;
+    RawCircBuf& operator=(RawCircBuf&&);
+    std::size_t head() const;
+    std::size_t tail() const;
+    std::size_t len() const;
+    std::size_t countToEnd() const;
+    std::size_t spaceToEnd() const;
+    std::size_t count() const;
+    std::size_t space() const;
+    T& front();
+    void clear();
+    template<typename... Args>
+    std::size_t emplace(Args&&...);
+    std::size_t pop(T&&);
+    std::size_t push(T&&);
+    std::size_t read(T*, std::size_t);
+    std::size_t write(T*, std::size_t);
+protected:
+    void* place(std::size_t);
+    T* slot(std::size_t);
+    void moveFrom(RawCircBuf&);
+    std::size_t _head{0};
+    std::size_t _tail{0};
+    alignas(T) std::byte _buf[N * sizeof(T)];
+};
+
+#include "RawCircBuf.hpp"
+
+}  // namespace Moving
+}  // namespace Circular
+
+#endif
@@ -0,0 +1,281 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+// A queue implemented using a contiguous buffer with separate indices for reading and writing.
+//
+// Elements are moved in to and out of the buffer.
+//
+// The head index is the next location to be written. It is incremented when items
+// are added and wraps to zero when it reaches the end of the linear buffer.
+//
+// The tail index is the next location to be read. It is incremented when items
+// are removed and wraps to zero when it reaches the end of the linear buffer.
+//
+// When the head index is equal to the tail index, the circular buffer is empty.
+// When the head index is one less than the tail index, the circular buffer is full.
+//
+// Unlike CircBuf, the buffer is uninitialised storage rather than an array of T,
+// so T need not be default constructible and no items are constructed until they
+// are added. emplace and push construct an item in its slot, and pop and read
+// destroy it as soon as it has been moved out, so the resources held by an item
+// are released when it is removed rather than when its slot is next written.
+//
+// As the items are stored inside the circular buffer, moving the circular buffer
+// moves every item.
+
+template<typename T, std::size_t N>
+std::ostream& operator<<(std::ostream& ostr, RawCircBuf<T, N>& cb)
+{
+    std::size_t i{cb._tail};
+
+    ostr << "{";
+    while (i != cb._head)
+    {
+        ostr << ' ' <<  *cb.slot(i);
+        if (++i >= cb.len())
+        {
+            i = 0;
+        }
+    }
+    ostr << " }";
+    return ostr;
+}
+
+template<typename T, std::size_t N>
+RawCircBuf<T, N>::RawCircBuf(RawCircBuf&& cb)
+{
+    moveFrom(cb);
+}
+
+template<typename T, std::size_t N>
+RawCircBuf<T, N>::~RawCircBuf()
+{
+    clear();
+}
+
+template<typename T, std::size_t N>
+RawCircBuf<T, N>& RawCircBuf<T, N>::operator=(RawCircBuf&& cb)
+{
+    if (this != &cb)
+    {
+        clear();
+        moveFrom(cb);
+    }
+    return *this;
+}
+
+template<typename T, std::size_t N>
+std::size_t RawCircBuf<T, N>::head() const
+{
+    return _head;
+}
+
+template<typename T, std::size_t N>
+std::size_t RawCircBuf<T, N>::tail() const
+{
+    return _tail;
+}
+
+template<typename T, std::size_t N>
+std::size_t RawCircBuf<T, N>::len() const
+{
+    return N;
+}
+
+// number of items present up to the end of the linear buffer or
+// the end of the circular buffer, whichever is smaller
+template<typename T, std::size_t N>
+std::size_t RawCircBuf<T, N>::countToEnd() const
+{
+    std::size_t countEndLinearBuf{N - _tail};
+    std::size_t countEndCircBuf{(_head + countEndLinearBuf) & (N - 1)};
+    return countEndCircBuf < countEndLinearBuf ? countEndCircBuf : countEndLinearBuf;
+}
+
+// space available to the end of the linear buffer or
+// the end of the circular buffer, whichever is smaller
+template<typename T, std::size_t N>
+std::size_t RawCircBuf<T, N>::spaceToEnd() const
+{
+    std::size_t spaceEndLinearBuf{N - _head};
+    std::size_t spaceEndCircBuf{(_tail + spaceEndLinearBuf - 1) & (N - 1)};
+    return spaceEndLinearBuf < spaceEndCircBuf ? spaceEndLinearBuf : spaceEndCircBuf;
+}
+
+// total number of items present in the circular buffer
+template<typename T, std::size_t N>
+std::size_t RawCircBuf<T, N>::count() const
+{
+    return (_head - _tail) & (N - 1);
+}
+
+// total space available for items in the circular buffer
+template<typename T, std::size_t N>
+std::size_t RawCircBuf<T, N>::space() const
+{
+    return (_tail - _head - 1) & (N - 1);
+}
+
+// the item at the tail
+// (the circular buffer must not be empty)
+template<typename T, std::size_t N>
+T& RawCircBuf<T, N>::front()
+{
+    return *slot(_tail);
+}
+
+// destroy every item present
+template<typename T, std::size_t N>
+void RawCircBuf<T, N>::clear()
+{
+    while (_tail != _head)
+    {
+        std::destroy_at(slot(_tail));
+        _tail = (_tail + 1) & (N - 1);
+    }
+    _head = 0;
+    _tail = 0;
+}
+
+// construct an item at the head from args
+// returns number of items added
+template<typename T, std::size_t N>
+template<typename... Args>
+std::size_t RawCircBuf<T, N>::emplace(Args&&... args)
+{
+    if (space() == 0)
+    {
+        return 0;
+    }
+    ::new (place(_head)) T(std::forward<Args>(args)...);
+    _head = (_head + 1) & (N - 1);
+    return 1;
+}
+
+// returns number of items popped
+template<typename T, std::size_t N>
+std::size_t RawCircBuf<T, N>::pop(T&& val)
+{
+    if (count() == 0)
+    {
+        return 0;
+    }
+    val = std::move(*slot(_tail));
+    std::destroy_at(slot(_tail));
+    _tail = (_tail + 1) & (N - 1);
+    return 1;
+}
+
+// returns number of items pushed
+template<typename T, std::size_t N>
+std::size_t RawCircBuf<T, N>::push(T&& val)
+{
+    return emplace(std::move(val));
+}
+
+// returns number of items read
+template<typename T, std::size_t N>
+std::size_t RawCircBuf<T, N>::read(T* buf, std::size_t len)
+{
+    std::size_t ret{0};
+
+    while (1)
+    {
+        std::size_t num{countToEnd()};
+        if (len < num)
+        {
+            num = len;
+        }
+        if (num <= 0)
+        {
+            break;
+        }
+        // remove each item as soon as it is destroyed, so that if moving
+        // the next one throws, the items removed so far are not destroyed again
+        for (std::size_t i{0}; i < num; i++)
+        {
+            *buf++ = std::move(*slot(_tail));
+            std::destroy_at(slot(_tail));
+            _tail = (_tail + 1) & (N - 1);
+        }
+        len -= num;
+        ret += num;
+    }
+    return ret;
+}
+
+// returns number of items written
+template<typename T, std::size_t N>
+std::size_t RawCircBuf<T, N>::write(T* buf, std::size_t len)
+{
+    std::size_t ret{0};
+
+    while (1)
+    {
+        std::size_t num{spaceToEnd()};
+        if (len < num)
+        {
+            num = len;
+        }
+        if (num <= 0)
+        {
+            break;
+        }
+        // add each item as soon as it is constructed, so that if moving
+        // the next one throws, the items added so far are kept
+        for (std::size_t i{0}; i < num; i++)
+        {
+            ::new (place(_head)) T(std::move(*buf++));
+            _head = (_head + 1) & (N - 1);
+        }
+        len -= num;
+        ret += num;
+    }
+    return ret;
+}
+
+// the storage for the item at index i
+template<typename T, std::size_t N>
+void* RawCircBuf<T, N>::place(std::size_t i)
+{
+    return _buf + i * sizeof(T);
+}
+
+// the item at index i, which must have been constructed
+template<typename T, std::size_t N>
+T* RawCircBuf<T, N>::slot(std::size_t i)
+{
+    return std::launder(reinterpret_cast<T*>(place(i)));
+}
+
+// move the items into the same slots and leave cb empty
+// (this circular buffer must be empty, and is left empty if a move throws)
+template<typename T, std::size_t N>
+void RawCircBuf<T, N>::moveFrom(RawCircBuf& cb)
+{
+    std::size_t i{cb._tail};
+
+    try
+    {
+        for (; i != cb._head; i = (i + 1) & (N - 1))
+        {
+            ::new (place(i)) T(std::move(*cb.slot(i)));
+        }
+    }
+    catch (...)
+    {
+        while (i != cb._tail)
+        {
+            i = (i - 1) & (N - 1);
+            std::destroy_at(slot(i));
+        }
+        throw;
+    }
+    _head = cb._head;
+    _tail = cb._tail;
+    cb.clear();
+}
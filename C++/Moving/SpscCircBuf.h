@@ -0,0 +1,64 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#ifndef SPSC_CIRC_BUF_H
+#define SPSC_CIRC_BUF_H
+
+#include <iostream>
+#include <array>
+#include <atomic>
+#include <algorithm>
+#include <utility>
+
+namespace Circular
+{
+namespace Moving
+{
+
+template<typename T, std::size_t N>
+class SpscCircBuf;
+
+template<typename T, std::size_t N>
+std::ostream& operator<<(std::ostream&, SpscCircBuf<T, N>&);
+
+template<typename T, std::size_t N>
+class SpscCircBuf
+{
+    static constexpr bool power_of_2(std::size_t i) {return (i > 0) && ((i & (i - 1)) == 0);}
+    static_assert(power_of_2(N), "N must be an integer power of 2");
+    static constexpr std::size_t cacheLineLen{64};
+    friend std::ostream& operator<< <T, N>(std::ostream&, SpscCircBuf&);
+public:
+    SpscCircBuf() = default;
+    SpscCircBuf(const SpscCircBuf&) = delete;
+    SpscCircBuf(SpscCircBuf&&) = delete;
+    virtual ~SpscCircBuf() = default;
+    SpscCircBuf& operator=(const SpscCircBuf&) = delete;
+    SpscCircBuf& operator=(SpscCircBuf&&) = delete;
+    std::size_t len() const;
+    std::size_t count() const;
+    std::size_t space() const;
+    std::size_t pop(T&&);
+    std::size_t push(T&&);
+    std::size_t read(T*, std::size_t);
+    std::size_t write(T*, std::size_t);
+protected:
+    // written by the producer
+    alignas(cacheLineLen) std::atomic<std::size_t> _head{0};
+    std::size_t _tailCache{0};
+    // written by the consumer
+    alignas(cacheLineLen) std::atomic<std::size_t> _tail{0};
+    std::size_t _headCache{0};
+    alignas(cacheLineLen) std::array<T, N> _buf{};
+};
+
+#include "SpscCircBuf.hpp"
+
+}  // namespace Moving
+}  // namespace Circular
+
+#endif
@@ -0,0 +1,162 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+// A single producer, single consumer queue implemented using a contiguous buffer
+// with separate atomic indices for reading and writing.
+//
+// Elements are moved in to and out of the buffer.
+//
+// The head index is the next location to be written. It is only modified by the
+// producer and is published with release ordering after the elements have been
+// moved in, so a consumer that loads it with acquire ordering sees the elements.
+//
+// The tail index is the next location to be read. It is only modified by the
+// consumer and is published with release ordering after the elements have been
+// moved out, so a producer that loads it with acquire ordering may reuse the space.
+//
+// The head and tail indices live on separate cache lines. Each side also keeps a
+// cached copy of the other side's index and only reloads the shared index when the
+// cached copy indicates that the buffer is full (producer) or empty (consumer).
+//
+// When the head index is equal to the tail index, the circular buffer is empty.
+// When the head index is one less than the tail index, the circular buffer is full.
+//
+// pop, push, read and write are safe to call concurrently provided that push and
+// write are only called by one thread and pop and read are only called by one
+// other thread.
+
+template<typename T, std::size_t N>
+std::ostream& operator<<(std::ostream& ostr, SpscCircBuf<T, N>& cb)
+{
+    std::size_t i{cb._tail.load(std::memory_order_acquire)};
+    std::size_t head{cb._head.load(std::memory_order_acquire)};
+
+    ostr << "{";
+    while (i != head)
+    {
+        ostr << ' ' <<  cb._buf[i];
+        if (++i >= cb.len())
+        {
+            i = 0;
+        }
+    }
+    ostr << " }";
+    return ostr;
+}
+
+template<typename T, std::size_t N>
+std::size_t SpscCircBuf<T, N>::len() const
+{
+    return N;
+}
+
+// total number of items present in the circular buffer
+template<typename T, std::size_t N>
+std::size_t SpscCircBuf<T, N>::count() const
+{
+    return (_head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire)) & (N - 1);
+}
+
+// total space available in the circular buffer
+template<typename T, std::size_t N>
+std::size_t SpscCircBuf<T, N>::space() const
+{
+    return (_tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire) - 1) & (N - 1);
+}
+
+// returns number of items popped
+template<typename T, std::size_t N>
+std::size_t SpscCircBuf<T, N>::pop(T&& val)
+{
+    std::size_t tail{_tail.load(std::memory_order_relaxed)};
+
+    if (tail == _headCache)
+    {
+        _headCache = _head.load(std::memory_order_acquire);
+        if (tail == _headCache)
+        {
+            return 0;
+        }
+    }
+    val = std::move(_buf[tail]);
+    _tail.store((tail + 1) & (N - 1), std::memory_order_release);
+    return 1;
+}
+
+// returns number of items pushed
+template<typename T, std::size_t N>
+std::size_t SpscCircBuf<T, N>::push(T&& val)
+{
+    std::size_t head{_head.load(std::memory_order_relaxed)};
+    std::size_t next{(head + 1) & (N - 1)};
+
+    if (next == _tailCache)
+    {
+        _tailCache = _tail.load(std::memory_order_acquire);
+        if (next == _tailCache)
+        {
+            return 0;
+        }
+    }
+    _buf[head] = std::move(val);
+    _head.store(next, std::memory_order_release);
+    return 1;
+}
+
+// returns number of items read
+template<typename T, std::size_t N>
+std::size_t SpscCircBuf<T, N>::read(T* buf, std::size_t len)
+{
+    std::size_t tail{_tail.load(std::memory_order_relaxed)};
+    std::size_t num{(_headCache - tail) & (N - 1)};
+
+    if (num < len)
+    {
+        _headCache = _head.load(std::memory_order_acquire);
+        num = (_headCache - tail) & (N - 1);
+    }
+    if (len < num)
+    {
+        num = len;
+    }
+    if (num <= 0)
+    {
+        return 0;
+    }
+    std::size_t first{N - tail < num ? N - tail : num};
+    std::move(_buf.begin() + tail, _buf.begin() + tail + first, buf);
+    std::move(_buf.begin(), _buf.begin() + (num - first), buf + first);
+    _tail.store((tail + num) & (N - 1), std::memory_order_release);
+    return num;
+}
+
+// returns number of items written
+template<typename T, std::size_t N>
+std::size_t SpscCircBuf<T, N>::write(T* buf, std::size_t len)
+{
+    std::size_t head{_head.load(std::memory_order_relaxed)};
+    std::size_t num{(_tailCache - head - 1) & (N - 1)};
+
+    if (num < len)
+    {
+        _tailCache = _tail.load(std::memory_order_acquire);
+        num = (_tailCache - head - 1) & (N - 1);
+    }
+    if (len < num)
+    {
+        num = len;
+    }
+    if (num <= 0)
+    {
+        return 0;
+    }
+    std::size_t first{N - head < num ? N - head : num};
+    std::move(buf, buf + first, _buf.begin() + head);
+    std::move(buf + first, buf + num, _buf.begin());
+    _head.store((head + num) & (N - 1), std::memory_order_release);
+    return num;
+}
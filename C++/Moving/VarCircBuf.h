@@ -0,0 +1,90 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#ifndef VAR_CIRC_BUF_H
+#define VAR_CIRC_BUF_H
+
+#include <iostream>
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <utility>
+#include <cerrno>
+
+namespace Circular
+{
+namespace Moving
+{
+
+template<typename T, typename A>
+class VarCircBuf;
+
+template<typename T, typename A>
+std::ostream& operator<<(std::ostream&, VarCircBuf<T, A>&);
+
+template<typename T, typename A>
+void swap(VarCircBuf<T, A>&, VarCircBuf<T, A>&);
+
+template<typename T, typename A = std::allocator<T>>
+class VarCircBuf
+{
+    static constexpr bool power_of_2(std::size_t i) {return (i > 0) && ((i & (i - 1)) == 0);}
+    typedef std::allocator_traits<A> Traits;
+    friend std::ostream& operator<< <T, A>(std::ostream&, VarCircBuf&);
+public:
+    typedef A allocator_type;
+    explicit VarCircBuf(std::size_t, const A& alloc = A());
+    VarCircBuf(const VarCircBuf&) = delete;
+    VarCircBuf(VarCircBuf&&);
+    virtual ~VarCircBuf();
+    VarCircBuf& operator=(const VarCircBuf&) = delete;
+    VarCircBuf& operator=(VarCircBuf&&);
+    void swap(VarCircBuf&);
+    A get_allocator() const;
+    std::size_t head() const;
+    void head(std::size_t);
+    std::size_t tail() const;
+    void tail(std::size_t);
+    std::size_t len() const;
+    std::span<T> buf();
+    std::size_t countToEnd() const;
+    std::size_t spaceToEnd() const;
+    std::size_t count() const;
+    std::size_t space() const;
+    std::size_t pop(T&&);
+    std::size_t push(T&&);
+    std::size_t read(T*, std::size_t);
+    std::size_t write(T*, std::size_t);
+    std::pair<std::span<T>, std::span<T>> reserve(std::size_t);
+    std::size_t commit(std::size_t);
+protected:
+    void allocate(std::size_t);
+    void construct(T*);
+    void release();
+    A _alloc;
+    T* _buf{nullptr};
+    std::size_t _len{0};
+    std::size_t _mask{0};
+    std::size_t _head{0};
+    std::size_t _tail{0};
+};
+
+namespace pmr
+{
+
+template<typename T>
+using VarCircBuf = Circular::Moving::VarCircBuf<T, std::pmr::polymorphic_allocator<T>>;
+
+}  // namespace pmr
+
+#include "VarCircBuf.hpp"
+
+}  // namespace Moving
+}  // namespace Circular
+
+#endif
@@ -0,0 +1,395 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+// A queue implemented using a contiguous buffer with separate indices for reading
+// and writing, in the same way as CircBuf, but with a length that is chosen when
+// it is constructed instead of when it is compiled.
+//
+// Elements are moved in to and out of the buffer.
+//
+// The length must still be an integer power of 2, so the indices wrap with the
+// same mask as CircBuf, which is kept alongside the length. The constructor
+// throws EINVAL for any other length.
+//
+// The buffer is obtained from an allocator, which is used and moved according to
+// std::allocator_traits in the same way as a standard container. pmr::VarCircBuf
+// uses a polymorphic allocator so that the buffer can be placed in a memory
+// resource such as an arena.
+//
+// Moving a circular buffer only moves the pointer to its buffer, unless the
+// allocators differ and do not propagate, in which case the items are moved one
+// by one into a new buffer and the old one is released. Either way a moved from
+// circular buffer has no buffer and a length of zero, so it is always both empty
+// and full. Swapping exchanges the buffers in the same way, and otherwise moves
+// the items so that each circular buffer keeps its allocator.
+
+template<typename T, typename A>
+std::ostream& operator<<(std::ostream& ostr, VarCircBuf<T, A>& cb)
+{
+    std::size_t i{cb._tail};
+
+    ostr << "{";
+    while (i != cb._head)
+    {
+        ostr << ' ' <<  cb._buf[i];
+        i = (i + 1) & cb._mask;
+    }
+    ostr << " }";
+    return ostr;
+}
+
+template<typename T, typename A>
+VarCircBuf<T, A>::VarCircBuf(std::size_t len, const A& alloc) : _alloc{alloc}
+{
+    if (!power_of_2(len))
+    {
+        throw EINVAL;
+    }
+    allocate(len);
+    construct(nullptr);
+}
+
+template<typename T, typename A>
+VarCircBuf<T, A>::VarCircBuf(VarCircBuf&& cb) :
+    _alloc{std::move(cb._alloc)}, _buf{cb._buf}, _len{cb._len}, _mask{cb._mask}, _head{cb._head}, _tail{cb._tail}
+{
+    cb._buf = nullptr;
+    cb._len = 0;
+    cb._mask = 0;
+    cb._head = 0;
+    cb._tail = 0;
+}
+
+template<typename T, typename A>
+VarCircBuf<T, A>::~VarCircBuf()
+{
+    release();
+}
+
+template<typename T, typename A>
+VarCircBuf<T, A>& VarCircBuf<T, A>::operator=(VarCircBuf&& cb)
+{
+    if (this == &cb)
+    {
+        return *this;
+    }
+    release();
+    if (Traits::propagate_on_container_move_assignment::value || _alloc == cb._alloc)
+    {
+        if constexpr (Traits::propagate_on_container_move_assignment::value)
+        {
+            _alloc = std::move(cb._alloc);
+        }
+        std::swap(_buf, cb._buf);
+        std::swap(_len, cb._len);
+        std::swap(_mask, cb._mask);
+        _head = cb._head;
+        _tail = cb._tail;
+        cb._head = 0;
+        cb._tail = 0;
+    }
+    else
+    {
+        // the buffer belongs to a different allocator, so move the items
+        // into a buffer of our own and release the other one
+        allocate(cb._len);
+        construct(cb._buf);
+        _head = cb._head;
+        _tail = cb._tail;
+        cb.release();
+    }
+    return *this;
+}
+
+// exchange the items of two circular buffers
+template<typename T, typename A>
+void VarCircBuf<T, A>::swap(VarCircBuf& cb)
+{
+    if (this == &cb)
+    {
+        return;
+    }
+    if (Traits::propagate_on_container_swap::value || _alloc == cb._alloc)
+    {
+        if constexpr (Traits::propagate_on_container_swap::value)
+        {
+            std::swap(_alloc, cb._alloc);
+        }
+        std::swap(_buf, cb._buf);
+        std::swap(_len, cb._len);
+        std::swap(_mask, cb._mask);
+        std::swap(_head, cb._head);
+        std::swap(_tail, cb._tail);
+        return;
+    }
+    // the buffers belong to different allocators that each circular buffer
+    // keeps, so move the items through a third circular buffer
+    VarCircBuf tmp(std::move(*this));
+    *this = std::move(cb);
+    cb = std::move(tmp);
+}
+
+template<typename T, typename A>
+void swap(VarCircBuf<T, A>& cb1, VarCircBuf<T, A>& cb2)
+{
+    cb1.swap(cb2);
+}
+
+template<typename T, typename A>
+A VarCircBuf<T, A>::get_allocator() const
+{
+    return _alloc;
+}
+
+template<typename T, typename A>
+std::size_t VarCircBuf<T, A>::head() const
+{
+    return _head;
+}
+
+template<typename T, typename A>
+void VarCircBuf<T, A>::head(std::size_t i)
+{
+    _head = i;
+}
+
+template<typename T, typename A>
+std::size_t VarCircBuf<T, A>::tail() const
+{
+    return _tail;
+}
+
+template<typename T, typename A>
+void VarCircBuf<T, A>::tail(std::size_t i)
+{
+    _tail = i;
+}
+
+template<typename T, typename A>
+std::size_t VarCircBuf<T, A>::len() const
+{
+    return _len;
+}
+
+template<typename T, typename A>
+std::span<T> VarCircBuf<T, A>::buf()
+{
+    return std::span<T>(_buf, _len);
+}
+
+// number of bytes present up to the end of the linear buffer or
+// the end of the circular buffer, whichever is smaller
+template<typename T, typename A>
+std::size_t VarCircBuf<T, A>::countToEnd() const
+{
+    std::size_t countEndLinearBuf{_len - _tail};
+    std::size_t countEndCircBuf{(_head + countEndLinearBuf) & _mask};
+    return countEndCircBuf < countEndLinearBuf ? countEndCircBuf : countEndLinearBuf;
+}
+
+// space available to the end of the linear buffer or
+// the end of the circular buffer, whichever is smaller
+template<typename T, typename A>
+std::size_t VarCircBuf<T, A>::spaceToEnd() const
+{
+    std::size_t spaceEndLinearBuf{_len - _head};
+    std::size_t spaceEndCircBuf{(_tail + spaceEndLinearBuf - 1) & _mask};
+    return spaceEndLinearBuf < spaceEndCircBuf ? spaceEndLinearBuf : spaceEndCircBuf;
+}
+
+// total number of items present in the circular buffer
+template<typename T, typename A>
+std::size_t VarCircBuf<T, A>::count() const
+{
+    return (_head - _tail) & _mask;
+}
+
+// total space available for items in the circular buffer
+template<typename T, typename A>
+std::size_t VarCircBuf<T, A>::space() const
+{
+    return (_tail - _head - 1) & _mask;
+}
+
+// returns number of items popped
+template<typename T, typename A>
+std::size_t VarCircBuf<T, A>::pop(T&& val)
+{
+    if (count() == 0)
+    {
+        return 0;
+    }
+    val = std::move(_buf[_tail]);
+    _tail = (_tail + 1) & _mask;
+    return 1;
+}
+
+// returns number of items pushed
+template<typename T, typename A>
+std::size_t VarCircBuf<T, A>::push(T&& val)
+{
+    if (space() == 0)
+    {
+        return 0;
+    }
+    _buf[_head] = std::move(val);
+    _head = (_head + 1) & _mask;
+    return 1;
+}
+
+// returns number of items read
+template<typename T, typename A>
+std::size_t VarCircBuf<T, A>::read(T* buf, std::size_t len)
+{
+    std::size_t ret{0};
+
+    while (1)
+    {
+        std::size_t num{countToEnd()};
+        if (len < num)
+        {
+            num = len;
+        }
+        if (num <= 0)
+        {
+            break;
+        }
+        for (std::size_t i = 0; i < num; i++)
+        {
+            *buf++ = std::move(_buf[i + _tail]);
+        }
+        _tail = (_tail + num) & _mask;
+        len -= num;
+        ret += num;
+    }
+    return ret;
+}
+
+// returns number of items written
+template<typename T, typename A>
+std::size_t VarCircBuf<T, A>::write(T* buf, std::size_t len)
+{
+    std::size_t ret{0};
+
+    while (1)
+    {
+        std::size_t num{spaceToEnd()};
+        if (len < num)
+        {
+            num = len;
+        }
+        if (num <= 0)
+        {
+            break;
+        }
+        for (std::size_t i = 0; i < num; i++)
+        {
+            _buf[i + _head] = std::move(*buf++);
+        }
+        _head = (_head + num) & _mask;
+        len -= num;
+        ret += num;
+    }
+    return ret;
+}
+
+// reserve space for up to len items at the head without adding them
+// returns the space before and after the end of the linear buffer
+// (the second span is empty unless the space wraps)
+template<typename T, typename A>
+std::pair<std::span<T>, std::span<T>> VarCircBuf<T, A>::reserve(std::size_t len)
+{
+    std::size_t num{space()};
+
+    if (len < num)
+    {
+        num = len;
+    }
+    std::size_t first{spaceToEnd()};
+    if (num < first)
+    {
+        first = num;
+    }
+    return {std::span<T>(_buf + _head, first), std::span<T>(_buf, num - first)};
+}
+
+// add the first len items of the reserved space to the circular buffer
+// returns number of items added
+template<typename T, typename A>
+std::size_t VarCircBuf<T, A>::commit(std::size_t len)
+{
+    std::size_t num{space()};
+
+    if (len < num)
+    {
+        num = len;
+    }
+    _head = (_head + num) & _mask;
+    return num;
+}
+
+// allocate a buffer of len items without constructing them
+template<typename T, typename A>
+void VarCircBuf<T, A>::allocate(std::size_t len)
+{
+    _buf = (len > 0) ? Traits::allocate(_alloc, len) : nullptr;
+    _len = len;
+    _mask = (len > 0) ? len - 1 : 0;
+}
+
+// construct the items of the buffer by moving them from buf,
+// or by value initialising them if buf is null
+template<typename T, typename A>
+void VarCircBuf<T, A>::construct(T* buf)
+{
+    std::size_t i{0};
+
+    try
+    {
+        for (; i < _len; i++)
+        {
+            if (buf == nullptr)
+            {
+                Traits::construct(_alloc, _buf + i);
+            }
+            else
+            {
+                Traits::construct(_alloc, _buf + i, std::move(buf[i]));
+            }
+        }
+    }
+    catch (...)
+    {
+        while (i > 0)
+        {
+            Traits::destroy(_alloc, _buf + --i);
+        }
+        Traits::deallocate(_alloc, _buf, _len);
+        _buf = nullptr;
+        _len = 0;
+        _mask = 0;
+        throw;
+    }
+}
+
+template<typename T, typename A>
+void VarCircBuf<T, A>::release()
+{
+    if (_buf != nullptr)
+    {
+        for (std::size_t i{0}; i < _len; i++)
+        {
+            Traits::destroy(_alloc, _buf + i);
+        }
+        Traits::deallocate(_alloc, _buf, _len);
+    }
+    _buf = nullptr;
+    _len = 0;
+    _mask = 0;
+    _head = 0;
+    _tail = 0;
+}
@@ -555,6 +555,89 @@ void testWriteFunc(testWriteData* data)
     }
 }
 
+struct TestReserveCommitData
+{
+    std::size_t start;
+    std::size_t end;
+    std::size_t len;
+    std::size_t expectedFirstLen;
+    std::size_t expectedSecondLen;
+    std::size_t commitLen;
+    std::size_t expectedNum;
+};
+
+TestReserveCommitData testReserveCommitData
+{
+    .start{0},
+    .end{0},
+    .len{5},
+    .expectedFirstLen{5},
+    .expectedSecondLen{0},
+    .commitLen{5},
+    .expectedNum{5}
+};
+
+TestReserveCommitData testReserveCommitWrapData
+{
+    .start{6},
+    .end{6},
+    .len{5},
+    .expectedFirstLen{2},
+    .expectedSecondLen{3},
+    .commitLen{4},
+    .expectedNum{4}
+};
+
+TestReserveCommitData testReserveCommitOverflowData
+{
+    .start{3},
+    .end{6},
+    .len{8},
+    .expectedFirstLen{2},
+    .expectedSecondLen{2},
+    .commitLen{8},
+    .expectedNum{4}
+};
+
+void testReserveCommitFunc(TestReserveCommitData* data)
+{
+    CircBuf<Elem, circBufLen> cb;
+
+    cb.head(data->end);
+    cb.tail(data->start);
+    std::size_t count{cb.count()};
+    auto [first, second]{cb.reserve(data->len)};
+    ASSERT_EQ(first.size(), data->expectedFirstLen);
+    ASSERT_EQ(second.size(), data->expectedSecondLen);
+    ASSERT_EQ(first.data(), cb.buf().data() + data->end);
+    ASSERT_EQ(second.data(), cb.buf().data());
+    // construct the items in place
+    std::size_t k{0};
+    for (auto& e : first)
+    {
+        e = Elem(++k);
+    }
+    for (auto& e : second)
+    {
+        e = Elem(++k);
+    }
+    ASSERT_EQ(cb.count(), count);
+    std::size_t num{cb.commit(data->commitLen)};
+    ASSERT_EQ(num, data->expectedNum);
+    ASSERT_EQ(cb.count(), count + num);
+    for (std::size_t i{0}; i < count; i++)
+    {
+        Elem val{};
+        ASSERT_EQ(cb.pop(std::move(val)), 1);
+    }
+    for (std::size_t i{0}; i < num; i++)
+    {
+        Elem val{};
+        ASSERT_EQ(cb.pop(std::move(val)), 1);
+        ASSERT_EQ(val.i, i + 1);
+    }
+}
+
 struct TestMultithreadedData
 {
     std::size_t numIter;
@@ -592,8 +675,86 @@ void testMultithreadedFunc(TestMultithreadedData* data)
     t.join();
 }
 
+struct TestHeapMoveData
+{
+    std::size_t head;
+    std::size_t tail;
+};
+
+TestHeapMoveData testHeapMoveData
+{
+    .head{2},
+    .tail{6}
+};
+
+void testHeapMoveFunc(TestHeapMoveData* data)
+{
+    // construct cb1
+    HeapCircBuf<Elem, circBufLen> cb1;
+    HeapArray<Elem, circBufLen>& p1{cb1.buf()};
+    for (std::size_t i{0}; i < circBufLen; i++)
+    {
+        p1[i].i = i;
+    }
+    cb1.head(data->head);
+    cb1.tail(data->tail);
+    const Elem* items{cb1.buf().data()};
+
+    // moving only moves the pointer to the items
+    HeapCircBuf<Elem, circBufLen> cb2(std::move(cb1));
+    ASSERT_EQ(cb2.buf().data(), items);
+    HeapArray<Elem, circBufLen>& p2{cb2.buf()};
+    for (std::size_t i{0}; i < circBufLen; i++)
+    {
+        ASSERT_EQ(p2[i].i, i);
+    }
+    ASSERT_EQ(cb2.head(), data->head);
+    ASSERT_EQ(cb2.tail(), data->tail);
+    ASSERT_EQ(cb1.head(), 0);
+    ASSERT_EQ(cb1.tail(), 0);
+
+    // cb1 has no storage, so it is both empty and full
+    Elem val{0};
+    std::array<Elem, circBufLen> vals{};
+    ASSERT_EQ(cb1.buf().size(), 0);
+    ASSERT_EQ(cb1.buf().data(), nullptr);
+    ASSERT_EQ(cb1.len(), 0);
+    ASSERT_EQ(cb1.count(), 0);
+    ASSERT_EQ(cb1.space(), 0);
+    ASSERT_EQ(cb1.spaceToEnd(), 0);
+    ASSERT_EQ(cb1.push(Elem(1)), 0);
+    ASSERT_EQ(cb1.pop(std::move(val)), 0);
+    ASSERT_EQ(cb1.write(vals.data(), circBufLen), 0);
+    ASSERT_EQ(cb1.read(vals.data(), circBufLen), 0);
+    auto spans{cb1.reserve(circBufLen)};
+    ASSERT_EQ(spans.first.size() + spans.second.size(), 0);
+    ASSERT_EQ(cb1.commit(circBufLen), 0);
+
+    // assignment moves the pointer and leaves cb2 with no storage,
+    // and assigning to cb1 lets it be used again
+    HeapCircBuf<Elem, circBufLen> cb3;
+    cb3 = std::move(cb2);
+    ASSERT_EQ(cb3.buf().data(), items);
+    ASSERT_EQ(cb2.buf().data(), nullptr);
+    ASSERT_EQ(cb2.len(), 0);
+    ASSERT_EQ(cb2.head(), 0);
+    ASSERT_EQ(cb2.tail(), 0);
+    HeapCircBuf<Elem, circBufLen> cb4;
+    const Elem* items4{cb4.buf().data()};
+    cb1 = std::move(cb4);
+    ASSERT_EQ(cb1.buf().data(), items4);
+    ASSERT_EQ(cb1.push(Elem(1)), 1);
+    ASSERT_EQ(cb1.count(), 1);
+    HeapArray<Elem, circBufLen>& p3{cb3.buf()};
+    for (std::size_t i{0}; i < circBufLen; i++)
+    {
+        ASSERT_EQ(p3[i].i, i);
+    }
+}
+
 TEST(testCircBuf, constructor) {testConstructorFunc(&testConstructorData);}
 TEST(testCircBuf, assignment) {testAssignmentFunc(&testAssignmentData);}
+TEST(testCircBuf, heapMove) {testHeapMoveFunc(&testHeapMoveData);}
 TEST(testCircBuf, space) {testSpaceFunc(&testSpaceData);}
 TEST(testCircBuf, count) {testCountFunc(&testCountData);}
 TEST(testCircBuf, pop) {testPopFunc(&testPopData);}
@@ -608,6 +769,9 @@ TEST(testCircBuf, writeFromSmallerBuffer) {testWriteFunc(&testWriteFromSmallerBu
 TEST(testCircBuf, writeFromLargerBuffer) {testWriteFunc(&testWriteFromLargerBufferData);}
 TEST(testCircBuf, tailHeadNzWriteFromSmallerBuffer) {testWriteFunc(&testTailHeadNzWriteFromSmallerBufferData);}
 TEST(testCircBuf, tailHeadNzWriteFromLargerBuffer) {testWriteFunc(&testTailHeadNzWriteFromLargerBufferData);}
+TEST(testCircBuf, reserveCommit) {testReserveCommitFunc(&testReserveCommitData);}
+TEST(testCircBuf, reserveCommitWrap) {testReserveCommitFunc(&testReserveCommitWrapData);}
+TEST(testCircBuf, reserveCommitOverflow) {testReserveCommitFunc(&testReserveCommitOverflowData);}
 TEST(testCircBuf, multithreaded) {testMultithreadedFunc(&testMultithreadedData);}
 
 int main(int argc, char** argv)
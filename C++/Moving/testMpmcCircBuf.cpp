@@ -0,0 +1,245 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#include "MpmcCircBuf.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <vector>
+#include <thread>
+#include <utility>
+
+using namespace Circular::Moving;
+
+constexpr std::size_t circBufLen{8};
+constexpr std::size_t maxNumIter{(circBufLen + circBufLen / 2)};
+
+struct Elem
+{
+    friend std::ostream& operator<<(std::ostream& ostr, Elem e) {ostr << e.i; return ostr;}
+    Elem() = default;
+    Elem(const Elem& e) : i{e.i} {}
+    Elem(Elem&& e) {std::swap(i, e.i);}
+    Elem(std::size_t sz) : i{sz} {}
+    Elem& operator=(const Elem& e) {i = e.i; return *this;}
+    Elem& operator=(Elem&& e) {std::swap(i, e.i); return *this;}
+    std::size_t i{0};
+};
+
+struct TestPushPopData
+{
+    std::size_t numIter;
+    std::size_t numLap;
+    std::array<std::size_t, maxNumIter> expectedNum;
+};
+
+TestPushPopData testPushPopData
+{
+    .numIter{maxNumIter},
+    .numLap{3},
+    .expectedNum{1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0}
+};
+
+void testPushPopFunc(TestPushPopData* data)
+{
+    MpmcCircBuf<Elem, circBufLen> cb;
+
+    // each lap reuses every slot with a new sequence number
+    for (std::size_t j{0}; j < data->numLap; j++)
+    {
+        for (std::size_t i{0}; i < data->numIter; i++)
+        {
+            Elem val{i + 1};
+            std::size_t num{cb.push(std::move(val))};
+            ASSERT_EQ(num, data->expectedNum.at(i));
+            ASSERT_EQ(val.i, num == 1 ? 0 : i + 1);
+        }
+        ASSERT_EQ(cb.count(), circBufLen);
+        ASSERT_EQ(cb.space(), 0);
+        for (std::size_t i{0}; i < data->numIter; i++)
+        {
+            Elem val{0};
+            std::size_t num{cb.pop(std::move(val))};
+            ASSERT_EQ(num, data->expectedNum.at(i));
+            ASSERT_EQ(val.i, num == 1 ? i + 1 : 0);
+        }
+        ASSERT_EQ(cb.count(), 0);
+        ASSERT_EQ(cb.space(), circBufLen);
+    }
+}
+
+struct TestReadWriteData
+{
+    std::size_t strLen;
+    std::size_t len;
+    std::size_t numIter;
+    std::array<std::size_t, maxNumIter> expectedWriteNum;
+    std::array<std::size_t, maxNumIter> expectedReadNum;
+};
+
+TestReadWriteData testReadWriteData
+{
+    .strLen{5},
+    .len{circBufLen},
+    .numIter{4},
+    .expectedWriteNum{5, 5, 5, 5},
+    .expectedReadNum{5, 5, 5, 5}
+};
+
+TestReadWriteData testReadWriteOverflowData
+{
+    .strLen{12},
+    .len{circBufLen},
+    .numIter{4},
+    .expectedWriteNum{8, 8, 8, 8},
+    .expectedReadNum{8, 8, 8, 8}
+};
+
+TestReadWriteData testReadIntoSmallerBufferData
+{
+    .strLen{6},
+    .len{4},
+    .numIter{4},
+    .expectedWriteNum{6, 6, 6, 6},
+    .expectedReadNum{4, 4, 4, 4}
+};
+
+void testReadWriteFunc(TestReadWriteData* data)
+{
+    MpmcCircBuf<Elem, circBufLen> cb;
+
+    // each iteration starts at a different offset so that the data wraps
+    for (std::size_t i{0}; i < data->numIter; i++)
+    {
+        Elem str[maxNumIter];
+        for (std::size_t j{0}; j < data->strLen; j++)
+        {
+            str[j].i = j + 1;
+        }
+        std::size_t num{cb.write(str, data->strLen)};
+        ASSERT_EQ(num, data->expectedWriteNum.at(i));
+        Elem buf[circBufLen];
+        num = cb.read(buf, data->len);
+        ASSERT_EQ(num, data->expectedReadNum.at(i));
+        for (std::size_t j{0}; j < num; j++)
+        {
+            ASSERT_EQ(buf[j].i, j + 1);
+        }
+        // discard anything left over
+        while (cb.read(buf, circBufLen) > 0)
+        {
+        }
+        ASSERT_EQ(cb.count(), 0);
+    }
+}
+
+struct TestMultithreadedData
+{
+    std::size_t numProducer;
+    std::size_t numConsumer;
+    std::size_t numElem;
+    std::size_t chunkLen;
+};
+
+TestMultithreadedData testMultithreadedSpscData
+{
+    .numProducer{1},
+    .numConsumer{1},
+    .numElem{100000},
+    .chunkLen{1}
+};
+
+TestMultithreadedData testMultithreadedMpmcData
+{
+    .numProducer{4},
+    .numConsumer{4},
+    .numElem{100000},
+    .chunkLen{1}
+};
+
+TestMultithreadedData testMultithreadedMpmcChunkData
+{
+    .numProducer{4},
+    .numConsumer{4},
+    .numElem{100000},
+    .chunkLen{5}
+};
+
+void testMultithreadedFunc(TestMultithreadedData* data)
+{
+    MpmcCircBuf<Elem, circBufLen> cb;
+    std::vector<std::atomic<std::size_t>> seen(data->numProducer * data->numElem);
+    std::atomic<std::size_t> numPopped{0};
+    std::vector<std::thread> threads;
+
+    for (std::size_t p{0}; p < data->numProducer; p++)
+    {
+        threads.emplace_back([&cb, data, p]()
+                             {
+                                 std::size_t i{0};
+                                 while (i < data->numElem)
+                                 {
+                                     Elem buf[circBufLen];
+                                     std::size_t len{data->numElem - i < data->chunkLen ? data->numElem - i : data->chunkLen};
+                                     for (std::size_t j{0}; j < len; j++)
+                                     {
+                                         buf[j].i = p * data->numElem + i + j;
+                                     }
+                                     std::size_t num{len == 1 ? cb.push(std::move(buf[0])) : cb.write(buf, len)};
+                                     if (num == 0)
+                                     {
+                                         std::this_thread::yield();
+                                     }
+                                     i += num;
+                                 }
+                             });
+    }
+    for (std::size_t c{0}; c < data->numConsumer; c++)
+    {
+        threads.emplace_back([&cb, &seen, &numPopped, data]()
+                             {
+                                 std::size_t total{data->numProducer * data->numElem};
+                                 while (numPopped.load() < total)
+                                 {
+                                     Elem buf[circBufLen];
+                                     std::size_t num{data->chunkLen == 1 ? cb.pop(std::move(buf[0])) : cb.read(buf, data->chunkLen)};
+                                     if (num == 0)
+                                     {
+                                         std::this_thread::yield();
+                                         continue;
+                                     }
+                                     for (std::size_t j{0}; j < num; j++)
+                                     {
+                                         seen.at(buf[j].i)++;
+                                     }
+                                     numPopped += num;
+                                 }
+                             });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    for (std::size_t i{0}; i < seen.size(); i++)
+    {
+        ASSERT_EQ(seen.at(i).load(), 1);
+    }
+    ASSERT_EQ(cb.count(), 0);
+}
+
+TEST(testMpmcCircBuf, pushPop) {testPushPopFunc(&testPushPopData);}
+TEST(testMpmcCircBuf, readWrite) {testReadWriteFunc(&testReadWriteData);}
+TEST(testMpmcCircBuf, readWriteOverflow) {testReadWriteFunc(&testReadWriteOverflowData);}
+TEST(testMpmcCircBuf, readIntoSmallerBuffer) {testReadWriteFunc(&testReadIntoSmallerBufferData);}
+TEST(testMpmcCircBuf, multithreadedSpsc) {testMultithreadedFunc(&testMultithreadedSpscData);}
+TEST(testMpmcCircBuf, multithreadedMpmc) {testMultithreadedFunc(&testMultithreadedMpmcData);}
+TEST(testMpmcCircBuf, multithreadedMpmcChunk) {testMultithreadedFunc(&testMultithreadedMpmcChunkData);}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
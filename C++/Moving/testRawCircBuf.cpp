@@ -0,0 +1,204 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#include "RawCircBuf.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cstdint>
+#include <cerrno>
+
+using namespace Circular::Moving;
+
+constexpr std::size_t circBufLen{8};
+
+// counts the live instances and has no default constructor
+struct Elem
+{
+    friend std::ostream& operator<<(std::ostream& ostr, const Elem& e) {ostr << e.i; return ostr;}
+    explicit Elem(std::size_t sz) : i{sz} {num++;}
+    Elem(const Elem& e) : i{e.i} {num++;}
+    Elem(Elem&& e) : i{e.i} {num++;}
+    ~Elem() {num--;}
+    Elem& operator=(const Elem& e) {i = e.i; return *this;}
+    Elem& operator=(Elem&& e) {i = e.i; return *this;}
+    std::size_t i;
+    inline static std::size_t num{0};
+};
+
+// counts the live instances and throws from a move once numMoves have succeeded
+struct ThrowingElem
+{
+    explicit ThrowingElem(std::size_t sz) : i{sz} {num++;}
+    ThrowingElem(ThrowingElem&& e) : i{e.i}
+    {
+        if (numMoves == 0)
+        {
+            throw EINVAL;
+        }
+        numMoves--;
+        num++;
+    }
+    ~ThrowingElem() {num--;}
+    ThrowingElem& operator=(ThrowingElem&& e) {i = e.i; return *this;}
+    std::size_t i;
+    inline static std::size_t num{0};
+    inline static std::size_t numMoves{SIZE_MAX};
+};
+
+TEST(testRawCircBuf, emplacePop)
+{
+    {
+        RawCircBuf<Elem, circBufLen> cb;
+
+        ASSERT_EQ(Elem::num, 0);
+        for (std::size_t i{0}; i < circBufLen; i++)
+        {
+            ASSERT_EQ(cb.emplace(i + 1), i < circBufLen - 1 ? 1 : 0);
+        }
+        ASSERT_EQ(Elem::num, circBufLen - 1);
+        ASSERT_EQ(cb.count(), circBufLen - 1);
+        ASSERT_EQ(cb.space(), 0);
+        Elem val{0};
+        for (std::size_t i{0}; i < 3; i++)
+        {
+            ASSERT_EQ(cb.front().i, i + 1);
+            ASSERT_EQ(cb.pop(std::move(val)), 1);
+            ASSERT_EQ(val.i, i + 1);
+        }
+        ASSERT_EQ(Elem::num, circBufLen - 3);
+        ASSERT_EQ(cb.push(Elem(42)), 1);
+        ASSERT_EQ(Elem::num, circBufLen - 2);
+    }
+    // the items left are destroyed with the circular buffer
+    ASSERT_EQ(Elem::num, 0);
+}
+
+TEST(testRawCircBuf, readWrite)
+{
+    RawCircBuf<std::string, circBufLen> cb;
+    std::array<std::string, circBufLen> in;
+    std::array<std::string, circBufLen> out;
+
+    for (std::size_t i{0}; i < 3; i++)
+    {
+        for (std::size_t j{0}; j < 5; j++)
+        {
+            in[j] = std::string(64, char('a' + j));
+        }
+        ASSERT_EQ(cb.write(in.data(), 5), 5);
+        ASSERT_EQ(cb.read(out.data(), out.size()), 5);
+        for (std::size_t j{0}; j < 5; j++)
+        {
+            ASSERT_EQ(out[j], std::string(64, char('a' + j)));
+        }
+    }
+    ASSERT_EQ(cb.count(), 0);
+}
+
+TEST(testRawCircBuf, destroyOnPop)
+{
+    RawCircBuf<std::shared_ptr<int>, circBufLen> cb;
+    auto p{std::make_shared<int>(42)};
+    std::shared_ptr<int> val;
+
+    ASSERT_EQ(cb.emplace(p), 1);
+    ASSERT_EQ(p.use_count(), 2);
+    ASSERT_EQ(cb.pop(std::move(val)), 1);
+    val.reset();
+    // no moved-from copy is left in the slot
+    ASSERT_EQ(p.use_count(), 1);
+    ASSERT_EQ(cb.emplace(p), 1);
+    ASSERT_EQ(cb.emplace(p), 1);
+    ASSERT_EQ(p.use_count(), 3);
+    cb.clear();
+    ASSERT_EQ(p.use_count(), 1);
+    ASSERT_EQ(cb.head(), 0);
+    ASSERT_EQ(cb.tail(), 0);
+}
+
+TEST(testRawCircBuf, move)
+{
+    {
+        RawCircBuf<Elem, circBufLen> cb1;
+        RawCircBuf<Elem, circBufLen> cb3;
+        Elem val{0};
+
+        for (std::size_t i{0}; i < 6; i++)
+        {
+            ASSERT_EQ(cb1.emplace(i), 1);
+        }
+        for (std::size_t i{0}; i < 4; i++)
+        {
+            ASSERT_EQ(cb1.pop(std::move(val)), 1);
+        }
+        for (std::size_t i{6}; i < 10; i++)
+        {
+            ASSERT_EQ(cb1.emplace(i), 1);
+        }
+        std::size_t head{cb1.head()};
+        std::size_t tail{cb1.tail()};
+        RawCircBuf<Elem, circBufLen> cb2(std::move(cb1));
+        ASSERT_EQ(cb2.head(), head);
+        ASSERT_EQ(cb2.tail(), tail);
+        ASSERT_EQ(cb1.count(), 0);
+        ASSERT_EQ(Elem::num, 7);
+        ASSERT_EQ(cb3.emplace(100), 1);
+        cb3 = std::move(cb2);
+        ASSERT_EQ(Elem::num, 7);
+        ASSERT_EQ(cb2.count(), 0);
+        for (std::size_t i{4}; i < 10; i++)
+        {
+            ASSERT_EQ(cb3.pop(std::move(val)), 1);
+            ASSERT_EQ(val.i, i);
+        }
+        ASSERT_EQ(cb3.pop(std::move(val)), 0);
+    }
+    ASSERT_EQ(Elem::num, 0);
+}
+
+TEST(testRawCircBuf, throwingMove)
+{
+    {
+        RawCircBuf<ThrowingElem, circBufLen> cb1;
+        std::vector<ThrowingElem> in;
+
+        for (std::size_t i{0}; i < 5; i++)
+        {
+            in.emplace_back(i);
+        }
+        ASSERT_EQ(cb1.emplace(std::size_t(100)), 1);
+        ASSERT_EQ(cb1.emplace(std::size_t(101)), 1);
+        // the items written before the move that throws are kept
+        ThrowingElem::numMoves = 2;
+        ASSERT_THROW(cb1.write(in.data(), in.size()), int);
+        ASSERT_EQ(cb1.count(), 4);
+        ASSERT_EQ(ThrowingElem::num, in.size() + 4);
+
+        // a move construction that throws leaves the items where they were
+        ThrowingElem::numMoves = 2;
+        ASSERT_THROW((RawCircBuf<ThrowingElem, circBufLen>(std::move(cb1))), int);
+        ASSERT_EQ(cb1.count(), 4);
+        ASSERT_EQ(ThrowingElem::num, in.size() + 4);
+
+        ThrowingElem::numMoves = SIZE_MAX;
+        RawCircBuf<ThrowingElem, circBufLen> cb2(std::move(cb1));
+        ASSERT_EQ(cb2.count(), 4);
+        ASSERT_EQ(cb2.front().i, 100);
+        ASSERT_EQ(ThrowingElem::num, in.size() + 4);
+    }
+    ASSERT_EQ(ThrowingElem::num, 0);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,199 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#include "SpscCircBuf.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <thread>
+#include <utility>
+
+using namespace Circular::Moving;
+
+constexpr std::size_t circBufLen{8};
+constexpr std::size_t maxNumIter{(circBufLen + circBufLen / 2)};
+
+struct Elem
+{
+    friend std::ostream& operator<<(std::ostream& ostr, Elem e) {ostr << e.i; return ostr;}
+    Elem() = default;
+    Elem(const Elem& e) : i{e.i} {}
+    Elem(Elem&& e) {std::swap(i, e.i);}
+    Elem(std::size_t sz) : i{sz} {}
+    Elem& operator=(const Elem& e) {i = e.i; return *this;}
+    Elem& operator=(Elem&& e) {std::swap(i, e.i); return *this;}
+    std::size_t i{0};
+};
+
+struct TestPushPopData
+{
+    std::size_t numIter;
+    std::array<std::size_t, maxNumIter> expectedPushNum;
+    std::array<std::size_t, maxNumIter> expectedPopNum;
+};
+
+TestPushPopData testPushPopData
+{
+    .numIter{maxNumIter},
+    .expectedPushNum{1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0},
+    .expectedPopNum{1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0}
+};
+
+void testPushPopFunc(TestPushPopData* data)
+{
+    SpscCircBuf<Elem, circBufLen> cb;
+
+    for (std::size_t i{0}; i < data->numIter; i++)
+    {
+        Elem val{i + 1};
+        std::size_t num{cb.push(std::move(val))};
+        ASSERT_EQ(num, data->expectedPushNum.at(i));
+        // a failed push leaves the item with the caller
+        if (num == 0)
+        {
+            ASSERT_EQ(val.i, i + 1);
+        }
+    }
+    ASSERT_EQ(cb.count(), circBufLen - 1);
+    ASSERT_EQ(cb.space(), 0);
+    for (std::size_t i{0}; i < data->numIter; i++)
+    {
+        Elem val{};
+        std::size_t num{cb.pop(std::move(val))};
+        ASSERT_EQ(num, data->expectedPopNum.at(i));
+        ASSERT_EQ(val.i, num == 0 ? 0 : i + 1);
+    }
+    ASSERT_EQ(cb.count(), 0);
+    ASSERT_EQ(cb.space(), circBufLen - 1);
+}
+
+struct TestReadWriteData
+{
+    std::size_t strLen;
+    std::size_t numIter;
+    std::array<std::size_t, maxNumIter> expectedWriteNum;
+    std::array<std::size_t, maxNumIter> expectedReadNum;
+};
+
+TestReadWriteData testReadWriteData
+{
+    .strLen{5},
+    .numIter{4},
+    .expectedWriteNum{5, 5, 5, 5},
+    .expectedReadNum{5, 5, 5, 5}
+};
+
+TestReadWriteData testReadWriteOverflowData
+{
+    .strLen{8},
+    .numIter{4},
+    .expectedWriteNum{7, 7, 7, 7},
+    .expectedReadNum{7, 7, 7, 7}
+};
+
+void testReadWriteFunc(TestReadWriteData* data)
+{
+    SpscCircBuf<Elem, circBufLen> cb;
+
+    // each iteration starts at a different offset so that the data wraps
+    for (std::size_t i{0}; i < data->numIter; i++)
+    {
+        Elem str[circBufLen]{};
+        for (std::size_t j{0}; j < data->strLen; j++)
+        {
+            str[j] = Elem(j + 1);
+        }
+        std::size_t num{cb.write(str, data->strLen)};
+        ASSERT_EQ(num, data->expectedWriteNum.at(i));
+        Elem buf[circBufLen]{};
+        num = cb.read(buf, circBufLen);
+        ASSERT_EQ(num, data->expectedReadNum.at(i));
+        for (std::size_t j{0}; j < num; j++)
+        {
+            ASSERT_EQ(buf[j].i, j + 1);
+        }
+        ASSERT_EQ(cb.count(), 0);
+    }
+}
+
+struct TestMultithreadedData
+{
+    std::size_t numElem;
+    std::size_t chunkLen;
+};
+
+TestMultithreadedData testMultithreadedData
+{
+    .numElem{1000000},
+    .chunkLen{1}
+};
+
+TestMultithreadedData testMultithreadedChunkData
+{
+    .numElem{1000000},
+    .chunkLen{5}
+};
+
+void testMultithreadedFunc(TestMultithreadedData* data)
+{
+    SpscCircBuf<Elem, circBufLen> cb;
+
+    std::thread consumer([&cb, data]()
+                    {
+                        std::size_t expected{0};
+                        while (expected < data->numElem)
+                        {
+                            Elem buf[circBufLen]{};
+                            std::size_t num{data->chunkLen == 1 ? cb.pop(std::move(buf[0])) : cb.read(buf, data->chunkLen)};
+                            if (num == 0)
+                            {
+                                std::this_thread::yield();
+                            }
+                            for (std::size_t i{0}; i < num; i++)
+                            {
+                                ASSERT_EQ(buf[i].i, expected++);
+                            }
+                        }
+                    });
+    std::thread producer([&cb, data]()
+                    {
+                        std::size_t next{0};
+                        while (next < data->numElem)
+                        {
+                            Elem buf[circBufLen]{};
+                            std::size_t len{data->chunkLen};
+                            if (data->numElem - next < len)
+                            {
+                                len = data->numElem - next;
+                            }
+                            for (std::size_t i{0}; i < len; i++)
+                            {
+                                buf[i] = Elem(next + i);
+                            }
+                            std::size_t num{len == 1 ? cb.push(std::move(buf[0])) : cb.write(buf, len)};
+                            if (num == 0)
+                            {
+                                std::this_thread::yield();
+                            }
+                            next += num;
+                        }
+                    });
+    producer.join();
+    consumer.join();
+    ASSERT_EQ(cb.count(), 0);
+}
+
+TEST(testSpscCircBuf, pushPop) {testPushPopFunc(&testPushPopData);}
+TEST(testSpscCircBuf, readWrite) {testReadWriteFunc(&testReadWriteData);}
+TEST(testSpscCircBuf, readWriteOverflow) {testReadWriteFunc(&testReadWriteOverflowData);}
+TEST(testSpscCircBuf, multithreaded) {testMultithreadedFunc(&testMultithreadedData);}
+TEST(testSpscCircBuf, multithreadedChunk) {testMultithreadedFunc(&testMultithreadedChunkData);}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
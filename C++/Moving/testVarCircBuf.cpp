@@ -0,0 +1,152 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#include "VarCircBuf.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+using namespace Circular::Moving;
+
+constexpr std::size_t circBufLen{8};
+
+typedef std::unique_ptr<int> Elem;
+
+TEST(testVarCircBuf, invalid)
+{
+    ASSERT_THROW((VarCircBuf<Elem>(0)), int);
+    ASSERT_THROW((VarCircBuf<Elem>(circBufLen + 1)), int);
+}
+
+TEST(testVarCircBuf, pushPop)
+{
+    VarCircBuf<Elem> cb(circBufLen);
+
+    ASSERT_EQ(cb.len(), circBufLen);
+    for (std::size_t i{0}; i < circBufLen; i++)
+    {
+        ASSERT_EQ(cb.push(std::make_unique<int>(i + 1)), i < circBufLen - 1 ? 1 : 0);
+    }
+    ASSERT_EQ(cb.count(), circBufLen - 1);
+    ASSERT_EQ(cb.space(), 0);
+    for (std::size_t i{0}; i < circBufLen - 1; i++)
+    {
+        Elem val;
+        ASSERT_EQ(cb.pop(std::move(val)), 1);
+        ASSERT_EQ(*val, int(i + 1));
+    }
+    Elem val;
+    ASSERT_EQ(cb.pop(std::move(val)), 0);
+}
+
+TEST(testVarCircBuf, readWrite)
+{
+    VarCircBuf<Elem> cb(circBufLen);
+    std::array<Elem, circBufLen> in;
+    std::array<Elem, circBufLen> out;
+
+    for (std::size_t i{0}; i < 3; i++)
+    {
+        for (std::size_t j{0}; j < 5; j++)
+        {
+            in[j] = std::make_unique<int>(j);
+        }
+        ASSERT_EQ(cb.write(in.data(), 5), 5);
+        ASSERT_EQ(cb.read(out.data(), out.size()), 5);
+        for (std::size_t j{0}; j < 5; j++)
+        {
+            ASSERT_EQ(*out[j], int(j));
+        }
+    }
+    auto spans{cb.reserve(circBufLen)};
+    ASSERT_EQ(spans.first.size() + spans.second.size(), circBufLen - 1);
+    ASSERT_EQ(cb.commit(2), 2);
+}
+
+TEST(testVarCircBuf, move)
+{
+    VarCircBuf<Elem> cb1(circBufLen);
+    Elem val;
+
+    ASSERT_EQ(cb1.push(std::make_unique<int>(1)), 1);
+    Elem* buf{cb1.buf().data()};
+    VarCircBuf<Elem> cb2(std::move(cb1));
+    ASSERT_EQ(cb2.buf().data(), buf);
+    ASSERT_EQ(cb2.count(), 1);
+    ASSERT_EQ(cb1.len(), 0);
+    ASSERT_EQ(cb1.push(std::make_unique<int>(2)), 0);
+    cb1 = std::move(cb2);
+    ASSERT_EQ(cb1.pop(std::move(val)), 1);
+    ASSERT_EQ(*val, 1);
+}
+
+TEST(testVarCircBuf, pmr)
+{
+    std::array<std::byte, 4096> arena{};
+    std::pmr::monotonic_buffer_resource res(arena.data(), arena.size(), std::pmr::null_memory_resource());
+    pmr::VarCircBuf<Elem> cb1(circBufLen, &res);
+    pmr::VarCircBuf<Elem> cb2(circBufLen);
+    Elem val;
+
+    auto p{reinterpret_cast<const std::byte*>(cb1.buf().data())};
+    ASSERT_TRUE(p >= arena.data() && p < arena.data() + arena.size());
+    ASSERT_EQ(cb1.push(std::make_unique<int>(42)), 1);
+    // the allocators differ and do not propagate, so the items are moved
+    cb2 = std::move(cb1);
+    ASSERT_EQ(cb2.get_allocator().resource(), std::pmr::get_default_resource());
+    ASSERT_EQ(cb2.pop(std::move(val)), 1);
+    ASSERT_EQ(*val, 42);
+    ASSERT_EQ(cb1.len(), 0);
+    ASSERT_EQ(cb1.count(), 0);
+    ASSERT_THROW((pmr::VarCircBuf<Elem>(4096, &res)), std::bad_alloc);
+}
+
+TEST(testVarCircBuf, swap)
+{
+    std::array<std::byte, 4096> arena{};
+    std::pmr::monotonic_buffer_resource res(arena.data(), arena.size(), std::pmr::null_memory_resource());
+    VarCircBuf<Elem> cb1(circBufLen);
+    VarCircBuf<Elem> cb2(2 * circBufLen);
+    pmr::VarCircBuf<Elem> cb3(circBufLen, &res);
+    pmr::VarCircBuf<Elem> cb4(2 * circBufLen);
+    Elem val;
+
+    // the allocators are equal, so the buffers are exchanged
+    ASSERT_EQ(cb1.push(std::make_unique<int>(1)), 1);
+    Elem* buf1{cb1.buf().data()};
+    Elem* buf2{cb2.buf().data()};
+    swap(cb1, cb2);
+    ASSERT_EQ(cb1.buf().data(), buf2);
+    ASSERT_EQ(cb1.len(), 2 * circBufLen);
+    ASSERT_EQ(cb1.count(), 0);
+    ASSERT_EQ(cb2.buf().data(), buf1);
+    ASSERT_EQ(cb2.pop(std::move(val)), 1);
+    ASSERT_EQ(*val, 1);
+
+    // the allocators differ and do not propagate, so the items are moved
+    // and each circular buffer keeps its allocator
+    ASSERT_EQ(cb3.push(std::make_unique<int>(3)), 1);
+    ASSERT_EQ(cb4.push(std::make_unique<int>(4)), 1);
+    swap(cb3, cb4);
+    auto p{reinterpret_cast<const std::byte*>(cb3.buf().data())};
+    ASSERT_TRUE(p >= arena.data() && p < arena.data() + arena.size());
+    ASSERT_EQ(cb3.len(), 2 * circBufLen);
+    ASSERT_EQ(cb3.pop(std::move(val)), 1);
+    ASSERT_EQ(*val, 4);
+    ASSERT_EQ(cb4.get_allocator().resource(), std::pmr::get_default_resource());
+    ASSERT_EQ(cb4.len(), circBufLen);
+    ASSERT_EQ(cb4.pop(std::move(val)), 1);
+    ASSERT_EQ(*val, 3);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,58 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include "WorkStealingDeque.h"
+#include "Chan.h"
+#include "EventCount.h"
+#include <functional>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <utility>
+#include <cerrno>
+
+namespace Circular
+{
+
+class ThreadPool
+{
+    typedef std::function<void()> Task;
+public:
+    static constexpr std::size_t dequeLen{256};
+    static constexpr std::size_t overflowLen{1024};
+    static constexpr std::size_t defaultSpin{256};
+    explicit ThreadPool(std::size_t numThreads = std::thread::hardware_concurrency(), std::size_t spin = defaultSpin);
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool(ThreadPool &&) = delete;
+    virtual ~ThreadPool();
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    ThreadPool &operator=(ThreadPool &&) = delete;
+    std::size_t size() const;
+    template<typename F>
+    void submit(F &&);
+protected:
+    void run(std::size_t);
+    bool take(std::size_t, Task *&);
+    inline static thread_local ThreadPool *_curPool{nullptr};
+    inline static thread_local std::size_t _curWorker{0};
+    std::vector<std::unique_ptr<WorkStealingDeque<Task *, dequeLen>>> _deques;
+    Chan<Task *, overflowLen> _overflow;
+    EventCount _idle;
+    std::atomic<bool> _stop{false};
+    std::size_t _spin;
+    std::vector<std::thread> _threads;
+};
+
+#include "ThreadPool.hpp"
+
+}  // namespace Circular
+
+#endif
@@ -0,0 +1,118 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+// A pool of worker threads that run submitted tasks, in which each worker owns
+// a work-stealing deque.
+//
+// A task submitted by a worker, for example a task that splits its work into
+// subtasks, is pushed on to the deque of that worker and is normally popped by
+// the same worker, so most submissions touch no shared state. A task submitted
+// by any other thread is pushed into an overflow channel, which blocks the
+// submitter when it is full.
+//
+// A worker looks for a task in its own deque first, then in the overflow channel
+// and then steals from the deques of the other workers in turn. A worker that
+// finds no task retries for up to spin iterations and then parks on an event
+// count, which every submission notifies, so submitting to a busy pool makes no
+// system calls.
+//
+// A worker whose deque is full moves the task to the overflow channel, and runs
+// the task itself if the overflow channel is also full, so that a worker never
+// blocks waiting for another worker.
+//
+// The destructor runs every task that has been submitted before it returns.
+
+inline ThreadPool::ThreadPool(std::size_t numThreads, std::size_t spin) : _spin{spin}
+{
+    if (numThreads == 0)
+    {
+        throw EINVAL;
+    }
+    for (std::size_t i{0}; i < numThreads; i++)
+    {
+        _deques.emplace_back(new WorkStealingDeque<Task *, dequeLen>);
+    }
+    for (std::size_t i{0}; i < numThreads; i++)
+    {
+        _threads.emplace_back(&ThreadPool::run, this, i);
+    }
+}
+
+inline ThreadPool::~ThreadPool()
+{
+    _stop.store(true, std::memory_order_release);
+    _idle.notifyAll();
+    for (auto &t : _threads)
+    {
+        t.join();
+    }
+}
+
+// number of worker threads
+inline std::size_t ThreadPool::size() const
+{
+    return _threads.size();
+}
+
+template<typename F>
+void ThreadPool::submit(F &&func)
+{
+    Task *task{new Task(std::forward<F>(func))};
+
+    if (_curPool == this)
+    {
+        if (_deques[_curWorker]->push(task) == 0 && _overflow.tryPush(std::move(task)) == 0)
+        {
+            (*task)();
+            delete task;
+            return;
+        }
+    }
+    else
+    {
+        _overflow.push(std::move(task));
+    }
+    _idle.notifyOne();
+}
+
+inline void ThreadPool::run(std::size_t id)
+{
+    Task *task{nullptr};
+
+    _curPool = this;
+    _curWorker = id;
+    for (;;)
+    {
+        _idle.await([&]() {return take(id, task) || _stop.load(std::memory_order_acquire);}, _spin);
+        if (task == nullptr)
+        {
+            break;
+        }
+        (*task)();
+        delete task;
+        task = nullptr;
+    }
+}
+
+// returns true if a task was found
+inline bool ThreadPool::take(std::size_t id, Task *&task)
+{
+    std::size_t num{_deques.size()};
+
+    if (_deques[id]->pop(task) == 1 || _overflow.tryPop(std::move(task)) == 1)
+    {
+        return true;
+    }
+    for (std::size_t i{1}; i < num; i++)
+    {
+        if (_deques[(id + i) % num]->steal(task) == 1)
+        {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,60 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+
+#include <iostream>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace Circular
+{
+
+template<typename T, std::size_t N>
+class WorkStealingDeque;
+
+template<typename T, std::size_t N>
+std::ostream &operator<<(std::ostream &, WorkStealingDeque<T, N> &);
+
+template<typename T, std::size_t N>
+class WorkStealingDeque
+{
+    static constexpr bool power_of_2(std::size_t i) {return (i > 0) && ((i & (i - 1)) == 0);}
+    static_assert(power_of_2(N), "N must be an integer power of 2");
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+    static constexpr std::size_t cacheLineLen{64};
+    friend std::ostream &operator<< <T, N>(std::ostream &, WorkStealingDeque &);
+public:
+    WorkStealingDeque() = default;
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+    WorkStealingDeque(WorkStealingDeque &&) = delete;
+    virtual ~WorkStealingDeque() = default;
+    WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+    WorkStealingDeque &operator=(WorkStealingDeque &&) = delete;
+    std::size_t len() const;
+    std::size_t count() const;
+    std::size_t space() const;
+    std::size_t push(const T &);
+    std::size_t pop(T &);
+    std::size_t steal(T &);
+protected:
+    // written by thieves and by the owner when taking the last item
+    alignas(cacheLineLen) std::atomic<std::int64_t> _top{0};
+    // written by the owner
+    alignas(cacheLineLen) std::atomic<std::int64_t> _bottom{0};
+    alignas(cacheLineLen) std::array<std::atomic<T>, N> _buf{};
+};
+
+#include "WorkStealingDeque.hpp"
+
+}  // namespace Circular
+
+#endif
@@ -0,0 +1,141 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+// A Chase-Lev work-stealing deque of fixed size, implemented using a contiguous
+// buffer with an atomic top index and an atomic bottom index.
+//
+// One thread, the owner, pushes and pops items at the bottom, so that it takes
+// back the most recent item first. Any number of other threads, the thieves,
+// steal items from the top, taking the oldest item first.
+//
+// The indices are never wrapped and are reduced modulo N to locate an item, so
+// all N items of the buffer are usable. The bottom index is only modified by
+// the owner. The top index is advanced with a compare and swap by a thief that
+// steals an item or by the owner when it pops the last item, which is the only
+// item that the owner and a thief can race for. Otherwise push and pop make no
+// atomic read-modify-write operations, and pop only needs a fence to order its
+// claim on the bottom item against the loads made by thieves.
+//
+// Items are copied in and out as whole atomic values, because a thief reads an
+// item before it knows whether it has won the race for it, so T must be
+// trivially copyable, for example a pointer to a task.
+//
+// A steal fails if the deque is empty or another thread took the top item
+// first, in which case the thief may try again.
+//
+// push and pop must only be called by the owner, and steal may be called by any
+// other thread.
+
+template<typename T, std::size_t N>
+std::ostream &operator<<(std::ostream &ostr, WorkStealingDeque<T, N> &dq)
+{
+    std::int64_t i{dq._top.load(std::memory_order_acquire)};
+    std::int64_t bottom{dq._bottom.load(std::memory_order_acquire)};
+
+    ostr << "{";
+    for (; i < bottom; i++)
+    {
+        ostr << ' ' << dq._buf[i & (N - 1)].load(std::memory_order_relaxed);
+    }
+    ostr << " }";
+    return ostr;
+}
+
+template<typename T, std::size_t N>
+std::size_t WorkStealingDeque<T, N>::len() const
+{
+    return N;
+}
+
+// total number of items present in the deque
+// (only a snapshot when other threads are active)
+template<typename T, std::size_t N>
+std::size_t WorkStealingDeque<T, N>::count() const
+{
+    std::int64_t top{_top.load(std::memory_order_acquire)};
+    std::int64_t bottom{_bottom.load(std::memory_order_acquire)};
+
+    return bottom > top ? std::size_t(bottom - top) : 0;
+}
+
+// total space available in the deque
+template<typename T, std::size_t N>
+std::size_t WorkStealingDeque<T, N>::space() const
+{
+    return N - count();
+}
+
+// push an item at the bottom
+// returns number of items pushed
+template<typename T, std::size_t N>
+std::size_t WorkStealingDeque<T, N>::push(const T &val)
+{
+    std::int64_t bottom{_bottom.load(std::memory_order_relaxed)};
+    std::int64_t top{_top.load(std::memory_order_acquire)};
+
+    if (bottom - top >= std::int64_t(N))
+    {
+        return 0;
+    }
+    _buf[bottom & (N - 1)].store(val, std::memory_order_relaxed);
+    _bottom.store(bottom + 1, std::memory_order_release);
+    return 1;
+}
+
+// pop the most recently pushed item from the bottom
+// returns number of items popped
+template<typename T, std::size_t N>
+std::size_t WorkStealingDeque<T, N>::pop(T &val)
+{
+    std::int64_t bottom{_bottom.load(std::memory_order_relaxed) - 1};
+
+    // claim the bottom item before looking at the top
+    _bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t top{_top.load(std::memory_order_relaxed)};
+    if (top > bottom)
+    {
+        // empty
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        return 0;
+    }
+    T tmp{_buf[bottom & (N - 1)].load(std::memory_order_relaxed)};
+    if (top == bottom)
+    {
+        // the last item, which a thief may be stealing
+        bool won{_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)};
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        if (!won)
+        {
+            return 0;
+        }
+    }
+    val = tmp;
+    return 1;
+}
+
+// steal the least recently pushed item from the top
+// returns number of items stolen
+template<typename T, std::size_t N>
+std::size_t WorkStealingDeque<T, N>::steal(T &val)
+{
+    std::int64_t top{_top.load(std::memory_order_acquire)};
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t bottom{_bottom.load(std::memory_order_acquire)};
+    if (top >= bottom)
+    {
+        return 0;
+    }
+    T tmp{_buf[top & (N - 1)].load(std::memory_order_relaxed)};
+    if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        return 0;
+    }
+    val = tmp;
+    return 1;
+}
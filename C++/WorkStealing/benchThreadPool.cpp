@@ -0,0 +1,161 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+// Measures the throughput of ThreadPool against a pool in which every worker
+// takes tasks from a single shared channel, for 1 up to all hardware threads.
+//
+// The external workload submits every task from the main thread. The fan out
+// workload submits a few root tasks that each submit many small subtasks from
+// a worker thread.
+
+#include "ThreadPool.h"
+#include "Chan.h"
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <utility>
+
+using namespace Circular;
+
+constexpr std::size_t numTasks{1000000};
+constexpr std::size_t numRoots{64};
+constexpr std::size_t chanLen{1024};
+
+// the pool that ThreadPool replaces
+class ChanPool
+{
+public:
+    explicit ChanPool(std::size_t numThreads)
+    {
+        for (std::size_t i{0}; i < numThreads; i++)
+        {
+            _threads.emplace_back([this]()
+                                  {
+                                      _curPool = this;
+                                      for (;;)
+                                      {
+                                          std::function<void()> task;
+                                          _chan.pop(std::move(task));
+                                          if (!task)
+                                          {
+                                              break;
+                                          }
+                                          task();
+                                      }
+                                  });
+        }
+    }
+    ~ChanPool()
+    {
+        for (std::size_t i{0}; i < _threads.size(); i++)
+        {
+            _chan.push(std::function<void()>());
+        }
+        for (auto &t : _threads)
+        {
+            t.join();
+        }
+    }
+    // a worker runs the task itself if the channel is full, as ThreadPool does,
+    // as otherwise every worker could block pushing subtasks
+    template<typename F>
+    void submit(F &&func)
+    {
+        std::function<void()> task(std::forward<F>(func));
+
+        if (_curPool != this)
+        {
+            _chan.push(std::move(task));
+        }
+        else if (_chan.tryPush(std::move(task)) == 0)
+        {
+            task();
+        }
+    }
+private:
+    inline static thread_local ChanPool *_curPool{nullptr};
+    Chan<std::function<void()>, chanLen> _chan;
+    std::vector<std::thread> _threads;
+};
+
+void waitFor(std::atomic<std::size_t> &num, std::size_t expected)
+{
+    while (num.load() < expected)
+    {
+        std::this_thread::yield();
+    }
+}
+
+// returns tasks per second
+template<typename Pool>
+double external(std::size_t numThreads)
+{
+    Pool pool(numThreads);
+    std::atomic<std::size_t> num{0};
+    auto start{std::chrono::steady_clock::now()};
+
+    for (std::size_t i{0}; i < numTasks; i++)
+    {
+        pool.submit([&num]() {num.fetch_add(1, std::memory_order_relaxed);});
+    }
+    waitFor(num, numTasks);
+    std::chrono::duration<double> secs{std::chrono::steady_clock::now() - start};
+    return numTasks / secs.count();
+}
+
+// returns tasks per second
+template<typename Pool>
+double fanOut(std::size_t numThreads)
+{
+    Pool pool(numThreads);
+    std::atomic<std::size_t> num{0};
+    auto start{std::chrono::steady_clock::now()};
+
+    for (std::size_t i{0}; i < numRoots; i++)
+    {
+        pool.submit([&pool, &num]()
+                    {
+                        for (std::size_t j{0}; j < numTasks / numRoots; j++)
+                        {
+                            pool.submit([&num]() {num.fetch_add(1, std::memory_order_relaxed);});
+                        }
+                    });
+    }
+    waitFor(num, numTasks);
+    std::chrono::duration<double> secs{std::chrono::steady_clock::now() - start};
+    return numTasks / secs.count();
+}
+
+int main()
+{
+    std::size_t maxThreads{std::thread::hardware_concurrency()};
+
+    if (maxThreads == 0)
+    {
+        maxThreads = 1;
+    }
+    std::cout << "tasks per second (millions)" << std::endl;
+    std::cout << std::setw(8) << "threads"
+              << std::setw(14) << "chan ext"
+              << std::setw(14) << "pool ext"
+              << std::setw(14) << "chan fanout"
+              << std::setw(14) << "pool fanout" << std::endl;
+    for (std::size_t n{1}; n <= maxThreads; n++)
+    {
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(8) << n
+                  << std::setw(14) << external<ChanPool>(n) / 1e6
+                  << std::setw(14) << external<ThreadPool>(n) / 1e6
+                  << std::setw(14) << fanOut<ChanPool>(n) / 1e6
+                  << std::setw(14) << fanOut<ThreadPool>(n) / 1e6 << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#include "ThreadPool.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <atomic>
+#include <vector>
+
+using namespace Circular;
+
+constexpr std::size_t numThreads{4};
+
+void waitFor(std::atomic<std::size_t> &num, std::size_t expected)
+{
+    while (num.load() < expected)
+    {
+        std::this_thread::yield();
+    }
+}
+
+TEST(testThreadPool, invalid)
+{
+    ASSERT_THROW(ThreadPool(0), int);
+}
+
+TEST(testThreadPool, submit)
+{
+    constexpr std::size_t numTasks{100000};
+    ThreadPool pool(numThreads);
+    std::atomic<std::size_t> num{0};
+
+    ASSERT_EQ(pool.size(), numThreads);
+    for (std::size_t i{0}; i < numTasks; i++)
+    {
+        pool.submit([&num]() {num++;});
+    }
+    waitFor(num, numTasks);
+    ASSERT_EQ(num.load(), numTasks);
+}
+
+TEST(testThreadPool, subtasks)
+{
+    // more subtasks than fit in a deque, so that some overflow
+    constexpr std::size_t numRoots{64};
+    constexpr std::size_t numSubtasks{4 * ThreadPool::dequeLen};
+    ThreadPool pool(numThreads);
+    std::atomic<std::size_t> num{0};
+
+    for (std::size_t i{0}; i < numRoots; i++)
+    {
+        pool.submit([&pool, &num]()
+                    {
+                        for (std::size_t j{0}; j < numSubtasks; j++)
+                        {
+                            pool.submit([&num]() {num++;});
+                        }
+                    });
+    }
+    waitFor(num, numRoots * numSubtasks);
+    ASSERT_EQ(num.load(), numRoots * numSubtasks);
+}
+
+TEST(testThreadPool, steal)
+{
+    // a worker that blocks must not strand the tasks in its deque
+    constexpr std::size_t numSubtasks{ThreadPool::dequeLen / 2};
+    ThreadPool pool(2);
+    std::atomic<std::size_t> num{0};
+    std::atomic<bool> release{false};
+
+    pool.submit([&pool, &num, &release]()
+                {
+                    for (std::size_t j{0}; j < numSubtasks; j++)
+                    {
+                        pool.submit([&num]() {num++;});
+                    }
+                    while (!release.load())
+                    {
+                        std::this_thread::yield();
+                    }
+                });
+    waitFor(num, numSubtasks);
+    release = true;
+    ASSERT_EQ(num.load(), numSubtasks);
+}
+
+TEST(testThreadPool, drain)
+{
+    constexpr std::size_t numTasks{10000};
+    std::atomic<std::size_t> num{0};
+
+    {
+        ThreadPool pool(numThreads);
+        for (std::size_t i{0}; i < numTasks; i++)
+        {
+            pool.submit([&num]() {num++;});
+        }
+    }
+    ASSERT_EQ(num.load(), numTasks);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
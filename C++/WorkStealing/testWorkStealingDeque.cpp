@@ -0,0 +1,237 @@
+// +--------------------------+
+// |                          |
+// |    Copyright (c) 2019    |
+// |       Keith Cullen       |
+// |                          |
+// +--------------------------+
+
+#include "WorkStealingDeque.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <memory>
+
+using namespace Circular;
+
+constexpr std::size_t dequeLen{8};
+constexpr std::size_t maxNumIter{(dequeLen + dequeLen / 2)};
+
+typedef int Elem;
+
+struct TestPushPopData
+{
+    std::size_t numIter;
+    std::array<std::size_t, maxNumIter> expectedPushNum;
+    std::array<std::size_t, maxNumIter> expectedPopNum;
+};
+
+TestPushPopData testPushPopData
+{
+    .numIter{maxNumIter},
+    .expectedPushNum{1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0},
+    .expectedPopNum{1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0}
+};
+
+void testPushPopFunc(TestPushPopData *data)
+{
+    WorkStealingDeque<Elem, dequeLen> dq;
+
+    for (std::size_t i{0}; i < data->numIter; i++)
+    {
+        std::size_t num{dq.push(Elem(i + 1))};
+        ASSERT_EQ(num, data->expectedPushNum.at(i));
+    }
+    ASSERT_EQ(dq.count(), dequeLen);
+    ASSERT_EQ(dq.space(), 0);
+    // the owner pops the most recent item first
+    for (std::size_t i{0}; i < data->numIter; i++)
+    {
+        Elem val{-1};
+        std::size_t num{dq.pop(val)};
+        ASSERT_EQ(num, data->expectedPopNum.at(i));
+        ASSERT_EQ(val, num == 0 ? -1 : Elem(dequeLen - i));
+    }
+    ASSERT_EQ(dq.count(), 0);
+    ASSERT_EQ(dq.space(), dequeLen);
+}
+
+TestPushPopData testPushStealData
+{
+    .numIter{maxNumIter},
+    .expectedPushNum{1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0},
+    .expectedPopNum{1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0}
+};
+
+void testPushStealFunc(TestPushPopData *data)
+{
+    WorkStealingDeque<Elem, dequeLen> dq;
+
+    // each iteration starts at a different offset so that the indices wrap
+    for (std::size_t j{0}; j < 3; j++)
+    {
+        for (std::size_t i{0}; i < data->numIter; i++)
+        {
+            std::size_t num{dq.push(Elem(i + 1))};
+            ASSERT_EQ(num, data->expectedPushNum.at(i));
+        }
+        // a thief steals the oldest item first
+        for (std::size_t i{0}; i < data->numIter; i++)
+        {
+            Elem val{0};
+            std::size_t num{dq.steal(val)};
+            ASSERT_EQ(num, data->expectedPopNum.at(i));
+            ASSERT_EQ(val, num == 0 ? 0 : Elem(i + 1));
+        }
+        Elem val{0};
+        ASSERT_EQ(dq.push(Elem(1)), 1);
+        ASSERT_EQ(dq.steal(val), 1);
+    }
+}
+
+struct TestLastItemData
+{
+    std::size_t numIter;
+};
+
+TestLastItemData testLastItemData
+{
+    .numIter{10000}
+};
+
+void testLastItemFunc(TestLastItemData *data)
+{
+    WorkStealingDeque<Elem, dequeLen> dq;
+    std::atomic<std::size_t> round{0};
+    std::atomic<std::size_t> done{0};
+    std::atomic<std::size_t> numStolen{0};
+    std::size_t numPopped{0};
+
+    // a thief tries to steal the only item in each round
+    std::thread thief([&dq, &round, &done, &numStolen, data]()
+                      {
+                          for (std::size_t r{1}; r <= data->numIter; r++)
+                          {
+                              while (round.load() < r)
+                              {
+                                  std::this_thread::yield();
+                              }
+                              Elem val{0};
+                              if (dq.steal(val) == 1)
+                              {
+                                  EXPECT_EQ(val, Elem(r));
+                                  numStolen++;
+                              }
+                              done.store(r);
+                          }
+                      });
+    // the owner races the thief for it, and must leave val alone if it loses
+    for (std::size_t r{1}; r <= data->numIter; r++)
+    {
+        EXPECT_EQ(dq.push(Elem(r)), 1);
+        round.store(r);
+        Elem val{-1};
+        std::size_t num{dq.pop(val)};
+        EXPECT_EQ(val, num == 0 ? -1 : Elem(r));
+        numPopped += num;
+        while (done.load() < r)
+        {
+            std::this_thread::yield();
+        }
+    }
+    thief.join();
+    ASSERT_EQ(numPopped + numStolen.load(), data->numIter);
+    ASSERT_EQ(dq.count(), 0);
+}
+
+struct TestMultithreadedData
+{
+    std::size_t numElem;
+    std::size_t numThieves;
+    std::size_t popInterval;
+};
+
+TestMultithreadedData testMultithreadedData
+{
+    .numElem{1000000},
+    .numThieves{3},
+    .popInterval{3}
+};
+
+void testMultithreadedFunc(TestMultithreadedData *data)
+{
+    WorkStealingDeque<Elem, dequeLen> dq;
+    std::unique_ptr<std::atomic<int>[]> taken(new std::atomic<int>[data->numElem]);
+    std::atomic<std::size_t> numTaken{0};
+    std::vector<std::thread> thieves;
+
+    for (std::size_t i{0}; i < data->numElem; i++)
+    {
+        taken[i] = 0;
+    }
+    for (std::size_t t{0}; t < data->numThieves; t++)
+    {
+        thieves.emplace_back([&dq, &taken, &numTaken, data]()
+                             {
+                                 while (numTaken.load() < data->numElem)
+                                 {
+                                     Elem val{0};
+                                     if (dq.steal(val) == 1)
+                                     {
+                                         taken[val]++;
+                                         numTaken++;
+                                     }
+                                     else
+                                     {
+                                         std::this_thread::yield();
+                                     }
+                                 }
+                             });
+    }
+    // the owner pops some of its own items and races the thieves for the rest
+    Elem next{0};
+    while (std::size_t(next) < data->numElem)
+    {
+        if (dq.push(next) == 1)
+        {
+            next++;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+        Elem val{0};
+        if (std::size_t(next) % data->popInterval == 0 && dq.pop(val) == 1)
+        {
+            taken[val]++;
+            numTaken++;
+        }
+    }
+    Elem val{0};
+    while (dq.pop(val) == 1)
+    {
+        taken[val]++;
+        numTaken++;
+    }
+    for (auto &t : thieves)
+    {
+        t.join();
+    }
+    ASSERT_EQ(numTaken.load(), data->numElem);
+    for (std::size_t i{0}; i < data->numElem; i++)
+    {
+        ASSERT_EQ(taken[i].load(), 1);
+    }
+}
+
+TEST(testWorkStealingDeque, pushPop) {testPushPopFunc(&testPushPopData);}
+TEST(testWorkStealingDeque, pushSteal) {testPushStealFunc(&testPushStealData);}
+TEST(testWorkStealingDeque, lastItem) {testLastItemFunc(&testLastItemData);}
+TEST(testWorkStealingDeque, multithreaded) {testMultithreadedFunc(&testMultithreadedData);}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -16,9 +16,25 @@
  *
  *  When the head index is equal to the tail index, the circular buffer is empty.
  *  When the head index is one less than the tail index, the circular buffer is full.
+ *
+ *  A mirrored circular buffer maps the same memory twice in succession, so that
+ *  the bytes that wrap past the end of the linear buffer also appear directly
+ *  after it. Every sequence of bytes is then contiguous, the copies are never
+ *  split at the wrap, and circ_buf_tail_ptr can be passed to any function that
+ *  expects a single buffer of circ_buf_count bytes.
+ *
+ *  circ_buf_fill_fd and circ_buf_drain_fd transfer bytes directly between a
+ *  file descriptor and the buffer with a single readv or writev call, using one
+ *  I/O vector for the bytes or space up to the end of the linear buffer and
+ *  another for the remainder at the start.
  */
 
+#define _GNU_SOURCE
+#include <errno.h>
 #include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
 #include "circ_buf.h"
 
 void circ_buf_init(circ_buf_t *cb, char *buf, unsigned len)
@@ -28,6 +44,68 @@ void circ_buf_init(circ_buf_t *cb, char *buf, unsigned len)
     cb->tail = 0;
     cb->buf = buf;
     cb->len = len;
+    cb->mirrored = 0;
+}
+
+/*  allocate a mirrored buffer of len bytes
+ *  (len must be an integer power of 2 and a multiple of the page size)
+ *  returns 0 or -errno
+ */
+int circ_buf_init_mirror(circ_buf_t *cb, unsigned len)
+{
+    long page_len = sysconf(_SC_PAGESIZE);
+    char *addr = NULL;
+    void *ret = NULL;
+    int err = 0;
+    int fd = -1;
+
+    if (len == 0 || (len & (len - 1)) != 0 || page_len <= 0 || len % page_len != 0)
+        return -EINVAL;
+    fd = memfd_create("circ_buf", MFD_CLOEXEC);
+    if (fd < 0)
+        return -errno;
+    if (ftruncate(fd, len) < 0)
+    {
+        err = errno;
+        close(fd);
+        return -err;
+    }
+    /* reserve the address range and then map the memory twice over it */
+    addr = mmap(NULL, 2 * (size_t)len, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED)
+    {
+        err = errno;
+        close(fd);
+        return -err;
+    }
+    ret = mmap(addr, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    if (ret != MAP_FAILED)
+        ret = mmap(addr + len, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    if (ret == MAP_FAILED)
+    {
+        err = errno;
+        munmap(addr, 2 * (size_t)len);
+        close(fd);
+        return -err;
+    }
+    /* the mappings keep the memory alive */
+    close(fd);
+    cb->head = 0;
+    cb->tail = 0;
+    cb->buf = addr;
+    cb->len = len;
+    cb->mirrored = 1;
+    return 0;
+}
+
+void circ_buf_free_mirror(circ_buf_t *cb)
+{
+    if (cb->mirrored)
+    {
+        munmap(cb->buf, 2 * (size_t)cb->len);
+        cb->buf = NULL;
+        cb->mirrored = 0;
+    }
 }
 
 /*  read data but don't update tail
@@ -122,3 +200,49 @@ int circ_buf_write(circ_buf_t *cb, const char *buf, unsigned len)
     }
     return ret;
 }
+
+/*  read from fd into all of the space in the circular buffer
+ *  returns number of bytes read, 0 at end of file, -ENOBUFS if the circular buffer is full or -errno
+ */
+int circ_buf_fill_fd(circ_buf_t *cb, int fd)
+{
+    struct iovec iov[2];
+    unsigned space = circ_buf_space(cb);
+    unsigned first = circ_buf_space_to_end(cb);
+    ssize_t ret = 0;
+
+    if (space == 0)
+        return -ENOBUFS;
+    iov[0].iov_base = cb->buf + cb->head;
+    iov[0].iov_len = first;
+    iov[1].iov_base = cb->buf;
+    iov[1].iov_len = space - first;
+    ret = readv(fd, iov, first < space ? 2 : 1);
+    if (ret < 0)
+        return -errno;
+    cb->head = circ_buf_wrap_index(cb, cb->head + ret);
+    return ret;
+}
+
+/*  write all of the bytes in the circular buffer to fd
+ *  returns number of bytes written or -errno
+ */
+int circ_buf_drain_fd(circ_buf_t *cb, int fd)
+{
+    struct iovec iov[2];
+    unsigned count = circ_buf_count(cb);
+    unsigned first = circ_buf_count_to_end(cb);
+    ssize_t ret = 0;
+
+    if (count == 0)
+        return 0;
+    iov[0].iov_base = cb->buf + cb->tail;
+    iov[0].iov_len = first;
+    iov[1].iov_base = cb->buf;
+    iov[1].iov_len = count - first;
+    ret = writev(fd, iov, first < count ? 2 : 1);
+    if (ret < 0)
+        return -errno;
+    cb->tail = circ_buf_wrap_index(cb, cb->tail + ret);
+    return ret;
+}
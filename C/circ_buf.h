@@ -13,25 +13,41 @@
 #define circ_buf_count(cb) (((cb)->head - (cb)->tail) & ((cb)->len - 1))
 
 /* space available to the end of the linear buffer */
+/* (all of the space when the buffer is mirrored) */
 #define circ_buf_space_to_end(cb)                                                            \
 ({                                                                                           \
     unsigned space_end_linear_buf = (cb)->len - (cb)->head;                                  \
     unsigned space_end_circ_buf = ((cb)->tail + space_end_linear_buf - 1) & ((cb)->len - 1); \
+    (cb)->mirrored ? circ_buf_space(cb) :                                                    \
     space_end_linear_buf < space_end_circ_buf ? space_end_linear_buf : space_end_circ_buf;   \
 })
 
 /* number of bytes present up to the end of the linear buffer */
+/* (all of the bytes when the buffer is mirrored) */
 /* this special version is required by circ_buf_peek */
 #define circ_buf_count_to_end_(cb, tail)                                                   \
 ({                                                                                         \
     unsigned count_end_linear_buf = (cb)->len - (tail);                                    \
     unsigned count_end_circ_buf = ((cb)->head + count_end_linear_buf) & ((cb)->len - 1);   \
+    (cb)->mirrored ? (((cb)->head - (tail)) & ((cb)->len - 1)) :                           \
     count_end_circ_buf < count_end_linear_buf ? count_end_circ_buf : count_end_linear_buf; \
 })
 
 /* number of bytes present up to the end of the linear buffer */
 #define circ_buf_count_to_end(cb)  circ_buf_count_to_end_(cb, (cb)->tail)
 
+/* next byte to be written in the circular buffer */
+/* (followed contiguously by circ_buf_space_to_end bytes of space) */
+#define circ_buf_head_ptr(cb)  ((cb)->buf + (cb)->head)
+
+/* add num bytes written at circ_buf_head_ptr to the circular buffer */
+/* (num must not exceed circ_buf_space_to_end) */
+#define circ_buf_advance_head(cb, num)  ((cb)->head = circ_buf_wrap_index((cb), (cb)->head + (num)))
+
+/* first byte present in the circular buffer */
+/* (followed contiguously by every byte present when the buffer is mirrored) */
+#define circ_buf_tail_ptr(cb)  ((cb)->buf + (cb)->tail)
+
 /* determine if the buffer is empty or not */
 #define circ_buf_is_empty(cb)  ((cb)->tail == (cb)->head)
 
@@ -49,14 +65,19 @@ typedef struct
     unsigned head; /* in index */
     unsigned tail; /* out index */
     unsigned len;  /* must be an integer power of 2 */
+    int mirrored;  /* buf is mapped twice in succession */
     char *buf;
 }
 circ_buf_t;
 
 void circ_buf_init(circ_buf_t *cb, char *buf, unsigned len);
+int circ_buf_init_mirror(circ_buf_t *cb, unsigned len);
+void circ_buf_free_mirror(circ_buf_t *cb);
 int circ_buf_peek(circ_buf_t *cb, char *buf, unsigned len);
 int circ_buf_consume(circ_buf_t *cb, unsigned len);
 int circ_buf_read(circ_buf_t *cb, char *buf, unsigned len);
 int circ_buf_write(circ_buf_t *cb, const char *buf, unsigned len);
+int circ_buf_fill_fd(circ_buf_t *cb, int fd);
+int circ_buf_drain_fd(circ_buf_t *cb, int fd);
 
 #endif
@@ -0,0 +1,178 @@
+/****************************
+ *    Copyright (c) 2010    *
+ *    Keith Cullen          *
+ ****************************/
+
+/*
+ *  Relays bytes from one file descriptor to another through a circular buffer stage.
+ *
+ *  When there is no transform and splice supports both ends, the bytes never enter
+ *  user space. They are spliced directly when either end is a pipe, and through a
+ *  stage pipe of its own otherwise. Each step moves at most the length of the
+ *  circular buffer, so the stage is the same size on both paths.
+ *
+ *  Otherwise the bytes are read into the circular buffer, transformed in place and
+ *  written out from it. The relay also falls back to this path if splice fails with
+ *  EINVAL, which it does for file descriptors that do not support it. Any bytes
+ *  already in the stage pipe are then read from it first, so the order is kept.
+ *
+ *  vmsplice is not used. It would have to map the bytes of the circular buffer into
+ *  a pipe, but the pages are only referenced by the pipe until the reader consumes
+ *  them, so the space could not be reused until then and there is no notification
+ *  of when that happens. Without SPLICE_F_GIFT the kernel copies the bytes anyway.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "circ_relay.h"
+
+static int circ_relay_is_pipe(int fd)
+{
+    struct stat st;
+
+    return fstat(fd, &st) == 0 && S_ISFIFO(st.st_mode);
+}
+
+/*  relay from in_fd to out_fd through the circular buffer
+ *  (transform may be NULL)
+ *  returns 0 or -errno
+ */
+int circ_relay_init(circ_relay_t *relay, circ_buf_t *cb, int in_fd, int out_fd, circ_relay_transform_t transform, void *arg)
+{
+    relay->cb = cb;
+    relay->in_fd = in_fd;
+    relay->out_fd = out_fd;
+    relay->pipe_fd[0] = -1;
+    relay->pipe_fd[1] = -1;
+    relay->pipe_count = 0;
+    relay->splice = (transform == NULL);
+    relay->transform = transform;
+    relay->arg = arg;
+    relay->spliced = 0;
+    relay->copied = 0;
+    if (relay->splice && !circ_relay_is_pipe(in_fd) && !circ_relay_is_pipe(out_fd))
+    {
+        if (pipe2(relay->pipe_fd, O_CLOEXEC) < 0)
+            return -errno;
+    }
+    return 0;
+}
+
+void circ_relay_free(circ_relay_t *relay)
+{
+    if (relay->pipe_fd[0] >= 0)
+    {
+        close(relay->pipe_fd[0]);
+        close(relay->pipe_fd[1]);
+        relay->pipe_fd[0] = -1;
+        relay->pipe_fd[1] = -1;
+    }
+}
+
+/*  zero-copy path
+ *  returns number of bytes written to out_fd, 0 at the end of the file or -errno
+ */
+static int circ_relay_splice(circ_relay_t *relay)
+{
+    ssize_t ret = 0;
+
+    if (relay->pipe_fd[0] < 0)
+    {
+        ret = splice(relay->in_fd, NULL, relay->out_fd, NULL, relay->cb->len, SPLICE_F_MOVE);
+        if (ret < 0)
+            return -errno;
+        relay->spliced += ret;
+        return ret;
+    }
+    if (relay->pipe_count == 0)
+    {
+        ret = splice(relay->in_fd, NULL, relay->pipe_fd[1], NULL, relay->cb->len, SPLICE_F_MOVE);
+        if (ret <= 0)
+            return (ret < 0) ? -errno : 0;
+        relay->pipe_count = ret;
+    }
+    ret = splice(relay->pipe_fd[0], NULL, relay->out_fd, NULL, relay->pipe_count, SPLICE_F_MOVE);
+    if (ret < 0)
+        return -errno;
+    /* out_fd took none of the bytes in the pipe, so they can never be written */
+    if (ret == 0)
+        return -EPIPE;
+    relay->pipe_count -= ret;
+    relay->spliced += ret;
+    /* a partial write leaves the rest in the pipe for the next step */
+    return ret;
+}
+
+/*  copy path
+ *  returns number of bytes written to out_fd, 0 at the end of the file or -errno
+ */
+static int circ_relay_copy(circ_relay_t *relay)
+{
+    circ_buf_t *cb = relay->cb;
+    unsigned first = 0;
+    unsigned count = 0;
+    int in_fd = (relay->pipe_count > 0) ? relay->pipe_fd[0] : relay->in_fd;
+    int ret = 0;
+
+    if (circ_buf_is_empty(cb))
+    {
+        ret = circ_buf_fill_fd(cb, in_fd);
+        if (ret <= 0)
+            return ret;
+        if (in_fd != relay->in_fd)
+            relay->pipe_count -= ret;
+        if (relay->transform != NULL)
+        {
+            /* the circular buffer was empty, so these are the only bytes present */
+            count = circ_buf_count(cb);
+            first = circ_buf_count_to_end(cb);
+            relay->transform(circ_buf_tail_ptr(cb), first, relay->arg);
+            if (first < count)
+                relay->transform(cb->buf, count - first, relay->arg);
+        }
+    }
+    ret = circ_buf_drain_fd(cb, relay->out_fd);
+    if (ret < 0)
+        return ret;
+    /* out_fd took none of the bytes in the circular buffer */
+    if (ret == 0)
+        return -EPIPE;
+    relay->copied += ret;
+    return ret;
+}
+
+/*  relay at most the length of the circular buffer
+ *  returns number of bytes written to out_fd, 0 at the end of the file or -errno
+ *  (-EPIPE if out_fd accepts none of the bytes waiting to be written to it)
+ */
+int circ_relay_step(circ_relay_t *relay)
+{
+    int ret = 0;
+
+    if (relay->splice)
+    {
+        ret = circ_relay_splice(relay);
+        if (ret != -EINVAL)
+            return ret;
+        /* splice is not supported by one of the file descriptors */
+        relay->splice = 0;
+    }
+    return circ_relay_copy(relay);
+}
+
+/*  relay until the end of the file
+ *  (the file descriptors should be blocking, and a step interrupted by a
+ *  signal is retried)
+ *  returns 0 or -errno
+ */
+int circ_relay_run(circ_relay_t *relay)
+{
+    int ret = 0;
+
+    while ((ret = circ_relay_step(relay)) > 0 || ret == -EINTR)
+        ;
+    return ret;
+}
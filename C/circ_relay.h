@@ -0,0 +1,34 @@
+/****************************
+ *    Copyright (c) 2010    *
+ *    Keith Cullen          *
+ ****************************/
+
+#ifndef CIRC_RELAY_H
+#define CIRC_RELAY_H
+
+#include "circ_buf.h"
+
+/* transform len bytes in place */
+typedef void (*circ_relay_transform_t)(char *buf, unsigned len, void *arg);
+
+typedef struct
+{
+    circ_buf_t *cb;
+    int in_fd;
+    int out_fd;
+    int pipe_fd[2];     /* stage used to splice when neither end is a pipe */
+    unsigned pipe_count; /* bytes in the stage pipe */
+    int splice;         /* the zero-copy path is in use */
+    circ_relay_transform_t transform;
+    void *arg;
+    unsigned long long spliced; /* bytes relayed on the zero-copy path */
+    unsigned long long copied;  /* bytes relayed through the circular buffer */
+}
+circ_relay_t;
+
+int circ_relay_init(circ_relay_t *relay, circ_buf_t *cb, int in_fd, int out_fd, circ_relay_transform_t transform, void *arg);
+void circ_relay_free(circ_relay_t *relay);
+int circ_relay_step(circ_relay_t *relay);
+int circ_relay_run(circ_relay_t *relay);
+
+#endif
@@ -0,0 +1,138 @@
+/****************************
+ *    Copyright (c) 2010    *
+ *    Keith Cullen          *
+ ****************************/
+
+/*
+ *  A queue implemented using a contiguous buffer with separate sequence numbers
+ *  for reading and writing.
+ *
+ *  Bytes are copied in to and out from the buffer.
+ *
+ *  The head is the sequence number of the next byte to be written and the tail
+ *  is the sequence number of the next byte to be read. Both are 64 bit counts
+ *  of the bytes that have passed through the buffer since it was initialised,
+ *  so they never wrap in practice, and they are only masked to index the linear
+ *  buffer when bytes are copied.
+ *
+ *  When the head is equal to the tail, the circular buffer is empty.
+ *  When the head is len more than the tail, the circular buffer is full.
+ *  Unlike circ_buf_t, no slot is kept empty to tell the two apart, so all len
+ *  bytes can be used.
+ *
+ *  The sequence numbers are absolute offsets into the stream of bytes, which a
+ *  consumer can use to report exact positions. circ_seq_buf_overwrite discards
+ *  the oldest bytes to make room instead of failing, and circ_seq_buf_peek_at
+ *  lets a consumer that keeps its own position find out that bytes it has not
+ *  seen have been discarded.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include "circ_seq_buf.h"
+
+/*  seq is the sequence number of the first byte to be written
+ */
+void circ_seq_buf_init(circ_seq_buf_t *cb, char *buf, unsigned len, uint64_t seq)
+{
+    memset(buf, 0, len);
+    cb->head = seq;
+    cb->tail = seq;
+    cb->buf = buf;
+    cb->len = len;
+}
+
+/*  read data starting at sequence number seq but don't update tail
+ *  returns number of bytes read, -ERANGE if the byte at seq has already been
+ *  removed (the gap is tail - seq bytes) or -EINVAL if seq is past the head
+ */
+int circ_seq_buf_peek_at(circ_seq_buf_t *cb, uint64_t seq, char *buf, unsigned len)
+{
+    unsigned num = 0;
+    int ret = 0;
+
+    if (seq < cb->tail)
+        return -ERANGE;
+    if (seq > cb->head)
+        return -EINVAL;
+    while (1)
+    {
+        num = circ_seq_buf_count_to_end_(cb, seq);
+        if (len < num)
+            num = len;
+        if (num <= 0)
+            break;
+        memcpy(buf, cb->buf + circ_seq_buf_index(cb, seq), num);
+        seq += num;
+        buf += num;
+        len -= num;
+        ret += num;
+    }
+    return ret;
+}
+
+/*  returns number of bytes removed
+ */
+int circ_seq_buf_consume(circ_seq_buf_t *cb, unsigned len)
+{
+    unsigned num = circ_seq_buf_count(cb);
+
+    if (len < num)
+        num = len;
+    cb->tail += num;
+    return num;
+}
+
+/*  returns number of bytes read
+ */
+int circ_seq_buf_read(circ_seq_buf_t *cb, char *buf, unsigned len)
+{
+    int ret = circ_seq_buf_peek_at(cb, cb->tail, buf, len);
+
+    cb->tail += ret;
+    return ret;
+}
+
+/*  returns number of bytes written
+ */
+int circ_seq_buf_write(circ_seq_buf_t *cb, const char *buf, unsigned len)
+{
+    unsigned num = 0;
+    int ret = 0;
+
+    while (1)
+    {
+        num = circ_seq_buf_space_to_end(cb);
+        if (len < num)
+            num = len;
+        if (num <= 0)
+            break;
+        memcpy(cb->buf + circ_seq_buf_index(cb, cb->head), buf, num);
+        cb->head += num;
+        buf += num;
+        len -= num;
+        ret += num;
+    }
+    return ret;
+}
+
+/*  write all of the data, discarding the oldest bytes to make room
+ *  (only the last len bytes are kept when more than len are written)
+ *  returns number of bytes written
+ */
+int circ_seq_buf_overwrite(circ_seq_buf_t *cb, const char *buf, unsigned len)
+{
+    unsigned skip = 0;
+    unsigned space = 0;
+
+    if (len > cb->len)
+    {
+        skip = len - cb->len;
+        cb->head += skip;
+        cb->tail = cb->head;
+    }
+    space = circ_seq_buf_space(cb);
+    if (len - skip > space)
+        cb->tail += len - skip - space;
+    return skip + circ_seq_buf_write(cb, buf + skip, len - skip);
+}
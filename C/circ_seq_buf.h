@@ -0,0 +1,61 @@
+/****************************
+ *    Copyright (c) 2010    *
+ *    Keith Cullen          *
+ ****************************/
+
+#ifndef CIRC_SEQ_BUF_H
+#define CIRC_SEQ_BUF_H
+
+#include <stdint.h>
+
+/* total number of bytes present in the circular buffer */
+#define circ_seq_buf_count(cb) ((unsigned)((cb)->head - (cb)->tail))
+
+/* total space available in the circular buffer */
+#define circ_seq_buf_space(cb) ((cb)->len - circ_seq_buf_count(cb))
+
+/* convert a sequence number into an index into the linear buffer */
+#define circ_seq_buf_index(cb, seq)  ((unsigned)(seq) & ((cb)->len - 1))
+
+/* space available to the end of the linear buffer */
+#define circ_seq_buf_space_to_end(cb)                                                 \
+({                                                                                    \
+    unsigned space_end_linear_buf = (cb)->len - circ_seq_buf_index((cb), (cb)->head); \
+    unsigned space = circ_seq_buf_space(cb);                                          \
+    space < space_end_linear_buf ? space : space_end_linear_buf;                      \
+})
+
+/* number of bytes present from seq up to the end of the linear buffer */
+#define circ_seq_buf_count_to_end_(cb, seq)                                      \
+({                                                                               \
+    unsigned count_end_linear_buf = (cb)->len - circ_seq_buf_index((cb), (seq)); \
+    unsigned count = (unsigned)((cb)->head - (seq));                             \
+    count < count_end_linear_buf ? count : count_end_linear_buf;                 \
+})
+
+/* number of bytes present up to the end of the linear buffer */
+#define circ_seq_buf_count_to_end(cb)  circ_seq_buf_count_to_end_(cb, (cb)->tail)
+
+/* determine if the buffer is empty or not */
+#define circ_seq_buf_is_empty(cb)  ((cb)->tail == (cb)->head)
+
+/* determine if the buffer is full or not */
+#define circ_seq_buf_is_full(cb)  (circ_seq_buf_count(cb) == (cb)->len)
+
+typedef struct
+{
+    uint64_t head; /* sequence number of the next byte to be written */
+    uint64_t tail; /* sequence number of the next byte to be read */
+    unsigned len;  /* must be an integer power of 2 */
+    char *buf;
+}
+circ_seq_buf_t;
+
+void circ_seq_buf_init(circ_seq_buf_t *cb, char *buf, unsigned len, uint64_t seq);
+int circ_seq_buf_peek_at(circ_seq_buf_t *cb, uint64_t seq, char *buf, unsigned len);
+int circ_seq_buf_consume(circ_seq_buf_t *cb, unsigned len);
+int circ_seq_buf_read(circ_seq_buf_t *cb, char *buf, unsigned len);
+int circ_seq_buf_write(circ_seq_buf_t *cb, const char *buf, unsigned len);
+int circ_seq_buf_overwrite(circ_seq_buf_t *cb, const char *buf, unsigned len);
+
+#endif
@@ -0,0 +1,401 @@
+/****************************
+ *    Copyright (c) 2010    *
+ *    Keith Cullen          *
+ ****************************/
+
+/*
+ *  Asynchronous streaming between file descriptors and a circular buffer using io_uring.
+ *
+ *  The io_uring instance is set up with the raw system calls and its submission
+ *  and completion queues are mapped directly, so there is no dependency on liburing.
+ *
+ *  Reads are queued into the free space of the circular buffer and writes are
+ *  queued from the bytes present in it, in segments of at most chunk_len bytes,
+ *  with up to depth operations in flight in each direction. A segment never crosses
+ *  the end of the linear buffer unless the buffer is mirrored.
+ *
+ *  Segments are handed out in order: rd_head runs ahead of the head index over the
+ *  space that reads have been queued into, and wr_tail runs ahead of the tail index
+ *  over the bytes that writes have been queued from. Operations complete in any
+ *  order, but the head and tail indices are only advanced over the oldest completed
+ *  operations, so the bytes in the circular buffer are always in file order.
+ *
+ *  A short transfer is queued again for the remainder of its segment. A write that
+ *  transfers no bytes fails with -EIO. A read that returns no bytes marks the end
+ *  of the file. Any later reads may have transferred
+ *  bytes from further on if the file was growing, so they are discarded and reading
+ *  resumes from the end of the last byte kept the next time the file is polled.
+ *
+ *  Either file descriptor may be -1, in which case the caller writes into or reads
+ *  from the circular buffer directly. In particular a growing file can be followed
+ *  by calling circ_uring_run again whenever it has returned, as the end of the file
+ *  is polled again once there is nothing else to do.
+ *
+ *  An error from any operation ends the stream, which must then be freed. The tail
+ *  index is only advanced over the bytes that were written before the first write
+ *  that failed, so the rest are left in the circular buffer.
+ *
+ *  With a file offset of -1 the current file position is used instead, which is
+ *  only well defined with a depth of 1.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "circ_uring.h"
+
+#define CIRC_URING_READ   0x100 /* user_data flag for read operations */
+
+static int circ_uring_setup(circ_uring_t *ur, unsigned entries)
+{
+    struct io_uring_params p;
+    int err = 0;
+
+    memset(&p, 0, sizeof(p));
+    ur->ring_fd = syscall(__NR_io_uring_setup, entries, &p);
+    if (ur->ring_fd < 0)
+        return -errno;
+    ur->sq_entries = p.sq_entries;
+    ur->sq_ring_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ur->cq_ring_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (ur->cq_ring_len > ur->sq_ring_len)
+            ur->sq_ring_len = ur->cq_ring_len;
+        ur->cq_ring_len = ur->sq_ring_len;
+    }
+    ur->sq_ring = mmap(NULL, ur->sq_ring_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ur->ring_fd, IORING_OFF_SQ_RING);
+    if (ur->sq_ring == MAP_FAILED)
+    {
+        err = errno;
+        close(ur->ring_fd);
+        return -err;
+    }
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        ur->cq_ring = ur->sq_ring;
+    }
+    else
+    {
+        ur->cq_ring = mmap(NULL, ur->cq_ring_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ur->ring_fd, IORING_OFF_CQ_RING);
+        if (ur->cq_ring == MAP_FAILED)
+        {
+            err = errno;
+            munmap(ur->sq_ring, ur->sq_ring_len);
+            close(ur->ring_fd);
+            return -err;
+        }
+    }
+    ur->sqes_len = p.sq_entries * sizeof(struct io_uring_sqe);
+    ur->sqes = mmap(NULL, ur->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ur->ring_fd, IORING_OFF_SQES);
+    if (ur->sqes == MAP_FAILED)
+    {
+        err = errno;
+        if (ur->cq_ring != ur->sq_ring)
+            munmap(ur->cq_ring, ur->cq_ring_len);
+        munmap(ur->sq_ring, ur->sq_ring_len);
+        close(ur->ring_fd);
+        return -err;
+    }
+    ur->sq_head = (unsigned *)((char *)ur->sq_ring + p.sq_off.head);
+    ur->sq_tail = (unsigned *)((char *)ur->sq_ring + p.sq_off.tail);
+    ur->sq_mask = (unsigned *)((char *)ur->sq_ring + p.sq_off.ring_mask);
+    ur->sq_array = (unsigned *)((char *)ur->sq_ring + p.sq_off.array);
+    ur->cq_head = (unsigned *)((char *)ur->cq_ring + p.cq_off.head);
+    ur->cq_tail = (unsigned *)((char *)ur->cq_ring + p.cq_off.tail);
+    ur->cq_mask = (unsigned *)((char *)ur->cq_ring + p.cq_off.ring_mask);
+    ur->cqes = (struct io_uring_cqe *)((char *)ur->cq_ring + p.cq_off.cqes);
+    ur->to_submit = 0;
+    return 0;
+}
+
+/*  set up a stream between in_fd, the circular buffer and out_fd
+ *  (either file descriptor may be -1)
+ *  (depth must be between 1 and CIRC_URING_MAX_OPS)
+ *  returns 0 or -errno
+ */
+int circ_uring_init(circ_uring_t *ur, circ_buf_t *cb, int in_fd, off_t in_off, int out_fd, off_t out_off, unsigned depth, unsigned chunk_len)
+{
+    if (depth == 0 || depth > CIRC_URING_MAX_OPS || chunk_len == 0)
+        return -EINVAL;
+    memset(ur, 0, sizeof(*ur));
+    ur->cb = cb;
+    ur->in_fd = in_fd;
+    ur->out_fd = out_fd;
+    ur->in_off = in_off;
+    ur->out_off = out_off;
+    ur->depth = depth;
+    ur->chunk_len = chunk_len;
+    ur->rd_head = cb->head;
+    ur->wr_tail = cb->tail;
+    /* every operation in flight has at most one submission queue entry */
+    return circ_uring_setup(ur, 2 * depth);
+}
+
+void circ_uring_free(circ_uring_t *ur)
+{
+    munmap(ur->sqes, ur->sqes_len);
+    if (ur->cq_ring != ur->sq_ring)
+        munmap(ur->cq_ring, ur->cq_ring_len);
+    munmap(ur->sq_ring, ur->sq_ring_len);
+    close(ur->ring_fd);
+}
+
+/* queue the remainder of an operation to the submission queue */
+static void circ_uring_prep(circ_uring_t *ur, int fd, int opcode, unsigned slot)
+{
+    circ_uring_queue_t *q = (opcode == IORING_OP_READ) ? &ur->rd : &ur->wr;
+    circ_uring_op_t *op = &q->ops[slot];
+    struct io_uring_sqe *sqe = NULL;
+    unsigned tail = *ur->sq_tail;
+    unsigned index = tail & *ur->sq_mask;
+
+    /* there is always an entry free as each operation has at most one */
+    sqe = &ur->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->addr = (unsigned long)(ur->cb->buf + op->start + op->done);
+    sqe->len = op->len - op->done;
+    sqe->off = (op->offset < 0) ? (__u64)-1 : (__u64)(op->offset + op->done);
+    sqe->user_data = (opcode == IORING_OP_READ ? CIRC_URING_READ : 0) | slot;
+    ur->sq_array[index] = index;
+    __atomic_store_n(ur->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ur->to_submit++;
+}
+
+/* add an operation for len bytes at start to the end of a queue */
+static unsigned circ_uring_push(circ_uring_queue_t *q, unsigned start, unsigned len, off_t offset)
+{
+    unsigned slot = (q->first + q->num) & (CIRC_URING_MAX_OPS - 1);
+    circ_uring_op_t *op = &q->ops[slot];
+
+    op->start = start;
+    op->len = len;
+    op->done = 0;
+    op->offset = offset;
+    op->complete = 0;
+    q->num++;
+    return slot;
+}
+
+/* queue reads into the free space that no read has been queued into yet */
+static void circ_uring_queue_reads(circ_uring_t *ur)
+{
+    circ_buf_t *cb = ur->cb;
+    unsigned space = 0;
+    unsigned to_end = 0;
+    unsigned len = 0;
+    unsigned slot = 0;
+
+    if (ur->in_fd < 0 || ur->eof || ur->rd_discard)
+        return;
+    while (ur->rd.num < ur->depth)
+    {
+        space = (cb->tail - ur->rd_head - 1) & (cb->len - 1);
+        to_end = cb->len - ur->rd_head;
+        len = (cb->mirrored || space < to_end) ? space : to_end;
+        if (len > ur->chunk_len)
+            len = ur->chunk_len;
+        if (len == 0)
+            break;
+        slot = circ_uring_push(&ur->rd, ur->rd_head, len, ur->in_off);
+        circ_uring_prep(ur, ur->in_fd, IORING_OP_READ, slot);
+        ur->rd_head = circ_buf_wrap_index(cb, ur->rd_head + len);
+        if (ur->in_off >= 0)
+            ur->in_off += len;
+    }
+}
+
+/* queue writes from the bytes that no write has been queued from yet */
+static void circ_uring_queue_writes(circ_uring_t *ur)
+{
+    circ_buf_t *cb = ur->cb;
+    unsigned count = 0;
+    unsigned to_end = 0;
+    unsigned len = 0;
+    unsigned slot = 0;
+
+    if (ur->out_fd < 0)
+        return;
+    while (ur->wr.num < ur->depth)
+    {
+        count = (cb->head - ur->wr_tail) & (cb->len - 1);
+        to_end = cb->len - ur->wr_tail;
+        len = (cb->mirrored || count < to_end) ? count : to_end;
+        if (len > ur->chunk_len)
+            len = ur->chunk_len;
+        if (len == 0)
+            break;
+        slot = circ_uring_push(&ur->wr, ur->wr_tail, len, ur->out_off);
+        circ_uring_prep(ur, ur->out_fd, IORING_OP_WRITE, slot);
+        ur->wr_tail = circ_buf_wrap_index(cb, ur->wr_tail + len);
+        if (ur->out_off >= 0)
+            ur->out_off += len;
+    }
+}
+
+/* advance the head index over the oldest completed reads */
+static void circ_uring_retire_reads(circ_uring_t *ur)
+{
+    circ_buf_t *cb = ur->cb;
+    circ_uring_op_t *op = NULL;
+
+    while (ur->rd.num > 0 && ur->rd.ops[ur->rd.first].complete)
+    {
+        op = &ur->rd.ops[ur->rd.first];
+        if (!ur->rd_discard)
+        {
+            cb->head = circ_buf_wrap_index(cb, cb->head + op->done);
+            ur->bytes_read += op->done;
+            if (op->done < op->len)
+            {
+                /* end of file, so discard every later read */
+                ur->eof = 1;
+                ur->rd_discard = 1;
+                if (op->offset >= 0)
+                    ur->in_off = op->offset + op->done;
+            }
+        }
+        ur->rd.first = (ur->rd.first + 1) & (CIRC_URING_MAX_OPS - 1);
+        ur->rd.num--;
+    }
+    if (ur->rd_discard && ur->rd.num == 0)
+    {
+        ur->rd_discard = 0;
+        ur->rd_head = cb->head;
+    }
+}
+
+/* advance the tail index over the oldest completed writes */
+/* (up to the end of the bytes written by the first write that failed) */
+static void circ_uring_retire_writes(circ_uring_t *ur)
+{
+    circ_buf_t *cb = ur->cb;
+    circ_uring_op_t *op = NULL;
+
+    while (ur->wr.num > 0 && ur->wr.ops[ur->wr.first].complete)
+    {
+        op = &ur->wr.ops[ur->wr.first];
+        cb->tail = circ_buf_wrap_index(cb, cb->tail + op->done);
+        ur->bytes_written += op->done;
+        if (op->done < op->len)
+        {
+            /* leave the remainder in the circular buffer and stop retiring */
+            op->start = circ_buf_wrap_index(cb, op->start + op->done);
+            op->len -= op->done;
+            if (op->offset >= 0)
+                op->offset += op->done;
+            op->done = 0;
+            break;
+        }
+        ur->wr.first = (ur->wr.first + 1) & (CIRC_URING_MAX_OPS - 1);
+        ur->wr.num--;
+    }
+}
+
+/* process one completion
+ * returns 0 or -errno
+ */
+static int circ_uring_complete(circ_uring_t *ur, struct io_uring_cqe *cqe)
+{
+    int rd = (cqe->user_data & CIRC_URING_READ) != 0;
+    unsigned slot = cqe->user_data & (CIRC_URING_MAX_OPS - 1);
+    circ_uring_op_t *op = rd ? &ur->rd.ops[slot] : &ur->wr.ops[slot];
+
+    if (cqe->res < 0)
+    {
+        if (cqe->res != -EINTR && cqe->res != -EAGAIN)
+        {
+            /* complete the operation so that it is not reaped again */
+            op->complete = 1;
+            return cqe->res;
+        }
+    }
+    else if (cqe->res == 0 && rd)
+    {
+        op->complete = 1;
+        return 0;
+    }
+    else if (cqe->res == 0)
+    {
+        /* a write that makes no progress would be queued again forever */
+        op->complete = 1;
+        return -EIO;
+    }
+    else
+    {
+        op->done += cqe->res;
+        if (op->done == op->len)
+        {
+            op->complete = 1;
+            return 0;
+        }
+    }
+    /* short transfer, so queue the remainder */
+    circ_uring_prep(ur, rd ? ur->in_fd : ur->out_fd, rd ? IORING_OP_READ : IORING_OP_WRITE, slot);
+    return 0;
+}
+
+/*  queue as many reads and writes as possible, wait for at least one
+ *  to complete and then process every completion
+ *  returns number of completions processed, 0 if there was nothing
+ *  to do or -errno
+ */
+int circ_uring_step(circ_uring_t *ur)
+{
+    struct io_uring_cqe *cqe = NULL;
+    unsigned head = 0;
+    unsigned tail = 0;
+    int num = 0;
+    int err = 0;
+    int ret = 0;
+
+    circ_uring_queue_reads(ur);
+    circ_uring_queue_writes(ur);
+    if (ur->rd.num == 0 && ur->wr.num == 0)
+    {
+        /* poll the input again on the next step */
+        ur->eof = 0;
+        return 0;
+    }
+    do
+    {
+        ret = syscall(__NR_io_uring_enter, ur->ring_fd, ur->to_submit, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+    }
+    while (ret < 0 && errno == EINTR);
+    if (ret < 0)
+        return -errno;
+    ur->to_submit -= ret;
+    head = *ur->cq_head;
+    tail = __atomic_load_n(ur->cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail)
+    {
+        cqe = &ur->cqes[head & *ur->cq_mask];
+        ret = circ_uring_complete(ur, cqe);
+        if (ret < 0 && err == 0)
+            err = ret;
+        head++;
+        num++;
+    }
+    __atomic_store_n(ur->cq_head, head, __ATOMIC_RELEASE);
+    circ_uring_retire_reads(ur);
+    circ_uring_retire_writes(ur);
+    return err < 0 ? err : num;
+}
+
+/*  step until there is nothing left to do
+ *  (copies in_fd to out_fd up to the end of the file)
+ *  returns 0 or -errno
+ */
+int circ_uring_run(circ_uring_t *ur)
+{
+    int ret = 0;
+
+    while ((ret = circ_uring_step(ur)) > 0)
+        ;
+    return ret;
+}
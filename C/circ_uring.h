@@ -0,0 +1,77 @@
+/****************************
+ *    Copyright (c) 2010    *
+ *    Keith Cullen          *
+ ****************************/
+
+#ifndef CIRC_URING_H
+#define CIRC_URING_H
+
+#include <sys/types.h>
+#include <linux/io_uring.h>
+#include "circ_buf.h"
+
+#define CIRC_URING_MAX_OPS  16  /* must be an integer power of 2 */
+
+typedef struct
+{
+    unsigned start; /* index into the circular buffer */
+    unsigned len;   /* bytes requested */
+    unsigned done;  /* bytes transferred */
+    off_t offset;   /* file offset or -1 */
+    int complete;
+}
+circ_uring_op_t;
+
+typedef struct
+{
+    circ_uring_op_t ops[CIRC_URING_MAX_OPS];
+    unsigned first; /* oldest operation in flight */
+    unsigned num;   /* number of operations in flight */
+}
+circ_uring_queue_t;
+
+typedef struct
+{
+    /* io_uring instance */
+    int ring_fd;
+    unsigned sq_entries;
+    void *sq_ring;
+    size_t sq_ring_len;
+    void *cq_ring;
+    size_t cq_ring_len;
+    struct io_uring_sqe *sqes;
+    size_t sqes_len;
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_cqe *cqes;
+    unsigned to_submit;
+    /* stream */
+    circ_buf_t *cb;
+    int in_fd;          /* -1 if the caller writes into the circular buffer */
+    int out_fd;         /* -1 if the caller reads from the circular buffer */
+    off_t in_off;       /* next file offset to read or -1 */
+    off_t out_off;      /* next file offset to write or -1 */
+    unsigned depth;     /* maximum operations in flight in each direction */
+    unsigned chunk_len; /* maximum bytes per operation */
+    unsigned rd_head;   /* index up to which reads have been queued */
+    unsigned wr_tail;   /* index up to which writes have been queued */
+    int eof;
+    int rd_discard;     /* reads after an end of file are being discarded */
+    circ_uring_queue_t rd;
+    circ_uring_queue_t wr;
+    unsigned long long bytes_read;
+    unsigned long long bytes_written;
+}
+circ_uring_t;
+
+int circ_uring_init(circ_uring_t *ur, circ_buf_t *cb, int in_fd, off_t in_off, int out_fd, off_t out_off, unsigned depth, unsigned chunk_len);
+void circ_uring_free(circ_uring_t *ur);
+int circ_uring_step(circ_uring_t *ur);
+int circ_uring_run(circ_uring_t *ur);
+
+#endif
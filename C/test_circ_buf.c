@@ -3,11 +3,20 @@
  *    Keith Cullen          *
  ****************************/
 
+#include <errno.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
 #include <string.h>
+#include <unistd.h>
 #include "circ_buf.h"
+#include "circ_uring.h"
+#include "circ_relay.h"
+#include "circ_seq_buf.h"
 
 #define BUF_LEN  8
+#define MIRROR_BUF_LEN  4096
+#define URING_BUF_LEN  1024
 
 struct test_space_data
 {
@@ -453,6 +462,717 @@ void test_peek_consume_func(const char *name, struct test_peek_consume_data *tes
     printf("%s\n", pass ? "PASS" : "FAIL");
 }
 
+struct test_mirror_data
+{
+    const char *str;
+    unsigned start;
+    unsigned num_iter;
+};
+
+struct test_mirror_data test_mirror_data =
+{
+    .str = "abcdefghijklmnopqrstuvwxyz0123456789",
+    .start = MIRROR_BUF_LEN - 10,
+    .num_iter = 3
+};
+
+void test_mirror_func(const char *name, struct test_mirror_data *test_data)
+{
+    circ_buf_t cb = {0};
+    unsigned i = 0;
+    unsigned str_len = strlen(test_data->str);
+    char out[64] = {0};
+    int pass = 1;
+    int ret = 0;
+
+    printf("%-60s...", name);
+
+    ret = circ_buf_init_mirror(&cb, MIRROR_BUF_LEN);
+    if (ret != 0)
+    {
+        printf("FAIL\n");
+        return;
+    }
+    /* start near the end of the linear buffer so that the data wraps */
+    cb.head = test_data->start;
+    cb.tail = test_data->start;
+    for (i = 0; i < test_data->num_iter; i++)
+    {
+        /* each write and read is a single copy */
+        if (circ_buf_space_to_end(&cb) != circ_buf_space(&cb))
+        {
+            pass = 0;
+        }
+        ret = circ_buf_write(&cb, test_data->str, str_len);
+        if (ret != str_len)
+        {
+            pass = 0;
+        }
+        if (circ_buf_count_to_end(&cb) != str_len)
+        {
+            pass = 0;
+        }
+        /* the data is contiguous at the tail even when it wraps */
+        if (memcmp(circ_buf_tail_ptr(&cb), test_data->str, str_len) != 0)
+        {
+            pass = 0;
+        }
+        /* the wrapped bytes are also at the start of the linear buffer */
+        if (cb.tail + str_len > MIRROR_BUF_LEN && cb.buf[0] != cb.buf[MIRROR_BUF_LEN])
+        {
+            pass = 0;
+        }
+        memset(out, 0, sizeof(out));
+        ret = circ_buf_read(&cb, out, sizeof(out));
+        if (ret != str_len || memcmp(out, test_data->str, str_len) != 0)
+        {
+            pass = 0;
+        }
+    }
+    circ_buf_free_mirror(&cb);
+    if (cb.buf != NULL || cb.mirrored)
+    {
+        pass = 0;
+    }
+    /* the length must be a power of 2 and a multiple of the page size */
+    if (circ_buf_init_mirror(&cb, BUF_LEN) != -EINVAL)
+    {
+        pass = 0;
+    }
+    if (circ_buf_init_mirror(&cb, 3 * MIRROR_BUF_LEN) != -EINVAL)
+    {
+        pass = 0;
+    }
+    printf("%s\n", pass ? "PASS" : "FAIL");
+}
+
+struct test_fd_data
+{
+    const char *str;
+    unsigned start;
+    unsigned num_iter;
+};
+
+struct test_fd_data test_fd_data =
+{
+    .str = "abcde",
+    .start = 5,
+    .num_iter = 3
+};
+
+void test_fd_func(const char *name, struct test_fd_data *test_data)
+{
+    circ_buf_t cb = {0};
+    unsigned i = 0;
+    unsigned str_len = strlen(test_data->str);
+    char buf[BUF_LEN] = {0};
+    char out[BUF_LEN] = {0};
+    int fds[2] = {-1, -1};
+    int pass = 1;
+    int ret = 0;
+
+    printf("%-60s...", name);
+
+    if (pipe(fds) < 0)
+    {
+        printf("FAIL\n");
+        return;
+    }
+    circ_buf_init(&cb, buf, sizeof(buf));
+    /* start near the end of the linear buffer so that the data wraps */
+    cb.head = test_data->start;
+    cb.tail = test_data->start;
+    for (i = 0; i < test_data->num_iter; i++)
+    {
+        if (write(fds[1], test_data->str, str_len) != str_len)
+        {
+            pass = 0;
+        }
+        ret = circ_buf_fill_fd(&cb, fds[0]);
+        if (ret != str_len || circ_buf_count(&cb) != str_len)
+        {
+            pass = 0;
+        }
+        ret = circ_buf_drain_fd(&cb, fds[1]);
+        if (ret != str_len || circ_buf_count(&cb) != 0)
+        {
+            pass = 0;
+        }
+        memset(out, 0, sizeof(out));
+        if (read(fds[0], out, sizeof(out)) != str_len || memcmp(out, test_data->str, str_len) != 0)
+        {
+            pass = 0;
+        }
+    }
+    /* nothing to drain */
+    if (circ_buf_drain_fd(&cb, fds[1]) != 0)
+    {
+        pass = 0;
+    }
+    /* bytes written at the head pointer */
+    memcpy(circ_buf_head_ptr(&cb), test_data->str, 1);
+    circ_buf_advance_head(&cb, 1);
+    if (circ_buf_count(&cb) != 1 || *circ_buf_tail_ptr(&cb) != test_data->str[0])
+    {
+        pass = 0;
+    }
+    /* full */
+    while (circ_buf_write(&cb, test_data->str, str_len) > 0)
+    {
+    }
+    if (circ_buf_fill_fd(&cb, fds[0]) != -ENOBUFS)
+    {
+        pass = 0;
+    }
+    /* end of file */
+    close(fds[1]);
+    circ_buf_consume(&cb, BUF_LEN);
+    if (circ_buf_fill_fd(&cb, fds[0]) != 0)
+    {
+        pass = 0;
+    }
+    close(fds[0]);
+    if (circ_buf_fill_fd(&cb, fds[0]) != -EBADF)
+    {
+        pass = 0;
+    }
+    printf("%s\n", pass ? "PASS" : "FAIL");
+}
+
+/* returns an unlinked temporary file or -1 */
+int temp_file(void)
+{
+    char path[] = "/tmp/test_circ_buf_XXXXXX";
+    int fd = mkstemp(path);
+
+    if (fd >= 0)
+        unlink(path);
+    return fd;
+}
+
+struct test_uring_copy_data
+{
+    unsigned file_len;
+    unsigned buf_len;
+    unsigned depth;
+    unsigned chunk_len;
+    int mirrored;
+};
+
+struct test_uring_copy_data test_uring_copy_data =
+{
+    .file_len = 100000,
+    .buf_len = URING_BUF_LEN,
+    .depth = 4,
+    .chunk_len = 100,
+    .mirrored = 0
+};
+
+struct test_uring_copy_data test_uring_copy_mirrored_data =
+{
+    .file_len = 100000,
+    .buf_len = MIRROR_BUF_LEN,
+    .depth = 8,
+    .chunk_len = 1000,
+    .mirrored = 1
+};
+
+void test_uring_copy_func(const char *name, struct test_uring_copy_data *test_data)
+{
+    circ_uring_t ur = {0};
+    circ_buf_t cb = {0};
+    unsigned i = 0;
+    char buf[URING_BUF_LEN] = {0};
+    char *in = NULL;
+    char *out = NULL;
+    int in_fd = -1;
+    int out_fd = -1;
+    int pass = 1;
+    int ret = 0;
+
+    printf("%-60s...", name);
+
+    in = malloc(test_data->file_len);
+    out = malloc(test_data->file_len);
+    in_fd = temp_file();
+    out_fd = temp_file();
+    if (in == NULL || out == NULL || in_fd < 0 || out_fd < 0)
+    {
+        printf("FAIL\n");
+        return;
+    }
+    for (i = 0; i < test_data->file_len; i++)
+    {
+        in[i] = 'a' + (i * 7) % 26;
+    }
+    if (write(in_fd, in, test_data->file_len) != test_data->file_len)
+    {
+        pass = 0;
+    }
+    if (test_data->mirrored)
+    {
+        if (circ_buf_init_mirror(&cb, test_data->buf_len) != 0)
+        {
+            pass = 0;
+        }
+    }
+    else
+    {
+        circ_buf_init(&cb, buf, test_data->buf_len);
+    }
+    ret = circ_uring_init(&ur, &cb, in_fd, 0, out_fd, 0, test_data->depth, test_data->chunk_len);
+    if (ret == -ENOSYS || ret == -EPERM)
+    {
+        /* io_uring is not supported or is disabled */
+        printf("SKIP\n");
+    }
+    else
+    {
+        if (ret != 0 || circ_uring_run(&ur) != 0)
+        {
+            pass = 0;
+        }
+        if (ur.bytes_read != test_data->file_len || ur.bytes_written != test_data->file_len || !circ_buf_is_empty(&cb))
+        {
+            pass = 0;
+        }
+        if (pread(out_fd, out, test_data->file_len, 0) != test_data->file_len
+         || memcmp(in, out, test_data->file_len) != 0)
+        {
+            pass = 0;
+        }
+        if (ret == 0)
+        {
+            circ_uring_free(&ur);
+        }
+        printf("%s\n", pass ? "PASS" : "FAIL");
+    }
+    if (test_data->mirrored)
+    {
+        circ_buf_free_mirror(&cb);
+    }
+    close(out_fd);
+    close(in_fd);
+    free(out);
+    free(in);
+}
+
+struct test_uring_error_data
+{
+    const char *str;
+    unsigned depth;
+    unsigned chunk_len;
+};
+
+struct test_uring_error_data test_uring_error_data =
+{
+    .str = "bytes that cannot be written",
+    .depth = 4,
+    .chunk_len = 8
+};
+
+void test_uring_error_func(const char *name, struct test_uring_error_data *test_data)
+{
+    circ_uring_t ur = {0};
+    circ_buf_t cb = {0};
+    char buf[URING_BUF_LEN] = {0};
+    unsigned str_len = strlen(test_data->str);
+    int pipe_fd[2] = {-1, -1};
+    int pass = 1;
+    int ret = 0;
+
+    printf("%-60s...", name);
+
+    if (pipe(pipe_fd) < 0)
+    {
+        printf("FAIL\n");
+        return;
+    }
+    circ_buf_init(&cb, buf, sizeof(buf));
+    if (circ_buf_write(&cb, test_data->str, str_len) != str_len)
+    {
+        pass = 0;
+    }
+    /* writing to the read end of a pipe fails */
+    ret = circ_uring_init(&ur, &cb, -1, -1, pipe_fd[0], -1, test_data->depth, test_data->chunk_len);
+    if (ret == -ENOSYS || ret == -EPERM)
+    {
+        /* io_uring is not supported or is disabled */
+        printf("SKIP\n");
+    }
+    else
+    {
+        if (ret != 0 || circ_uring_run(&ur) >= 0)
+        {
+            pass = 0;
+        }
+        /* the bytes that were not written are left in the circular buffer */
+        if (ur.bytes_written != 0 || circ_buf_count(&cb) != str_len)
+        {
+            pass = 0;
+        }
+        if (ret == 0)
+        {
+            circ_uring_free(&ur);
+        }
+        printf("%s\n", pass ? "PASS" : "FAIL");
+    }
+    close(pipe_fd[1]);
+    close(pipe_fd[0]);
+}
+
+struct test_uring_follow_data
+{
+    const char *str;
+    unsigned num_iter;
+};
+
+struct test_uring_follow_data test_uring_follow_data =
+{
+    .str = "a line appended to a log\n",
+    .num_iter = 50
+};
+
+void test_uring_follow_func(const char *name, struct test_uring_follow_data *test_data)
+{
+    circ_uring_t ur = {0};
+    circ_buf_t cb = {0};
+    unsigned i = 0;
+    unsigned str_len = strlen(test_data->str);
+    char buf[URING_BUF_LEN] = {0};
+    char out[URING_BUF_LEN] = {0};
+    int fd = -1;
+    int pass = 1;
+    int ret = 0;
+
+    printf("%-60s...", name);
+
+    fd = temp_file();
+    if (fd < 0)
+    {
+        printf("FAIL\n");
+        return;
+    }
+    circ_buf_init(&cb, buf, sizeof(buf));
+    /* the caller reads from the circular buffer */
+    ret = circ_uring_init(&ur, &cb, fd, 0, -1, 0, 4, 16);
+    if (ret == -ENOSYS || ret == -EPERM)
+    {
+        printf("SKIP\n");
+        close(fd);
+        return;
+    }
+    if (ret != 0)
+    {
+        printf("FAIL\n");
+        close(fd);
+        return;
+    }
+    /* nothing to read yet */
+    if (circ_uring_run(&ur) != 0 || !circ_buf_is_empty(&cb))
+    {
+        pass = 0;
+    }
+    for (i = 0; i < test_data->num_iter; i++)
+    {
+        /* the file grows between polls */
+        if (write(fd, test_data->str, str_len) != str_len)
+        {
+            pass = 0;
+        }
+        if (circ_uring_run(&ur) != 0)
+        {
+            pass = 0;
+        }
+        memset(out, 0, sizeof(out));
+        ret = circ_buf_read(&cb, out, sizeof(out));
+        if (ret != str_len || memcmp(out, test_data->str, str_len) != 0)
+        {
+            pass = 0;
+        }
+    }
+    if (ur.bytes_read != (unsigned long long)test_data->num_iter * str_len)
+    {
+        pass = 0;
+    }
+    circ_uring_free(&ur);
+    close(fd);
+    printf("%s\n", pass ? "PASS" : "FAIL");
+}
+
+void upper_func(char *buf, unsigned len, void *arg)
+{
+    unsigned *num = arg;
+    unsigned i = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        buf[i] = toupper(buf[i]);
+    }
+    *num += len;
+}
+
+struct test_relay_data
+{
+    unsigned file_len;
+    int in_pipe;
+    int transform;
+};
+
+struct test_relay_data test_relay_file_data =
+{
+    .file_len = 100000,
+    .in_pipe = 0,
+    .transform = 0
+};
+
+struct test_relay_data test_relay_pipe_data =
+{
+    .file_len = 10000,
+    .in_pipe = 1,
+    .transform = 0
+};
+
+struct test_relay_data test_relay_transform_data =
+{
+    .file_len = 100000,
+    .in_pipe = 0,
+    .transform = 1
+};
+
+void test_relay_func(const char *name, struct test_relay_data *test_data)
+{
+    circ_relay_t relay = {0};
+    circ_buf_t cb = {0};
+    unsigned i = 0;
+    unsigned num_transformed = 0;
+    char buf[URING_BUF_LEN] = {0};
+    char *in = NULL;
+    char *out = NULL;
+    int fds[2] = {-1, -1};
+    int in_fd = -1;
+    int out_fd = -1;
+    int pass = 1;
+    int ret = 0;
+
+    printf("%-60s...", name);
+
+    in = malloc(test_data->file_len);
+    out = malloc(test_data->file_len);
+    out_fd = temp_file();
+    if (test_data->in_pipe)
+    {
+        /* the data fits in the pipe, so the write end can be closed first */
+        if (pipe(fds) == 0)
+            in_fd = fds[0];
+    }
+    else
+    {
+        in_fd = temp_file();
+    }
+    if (in == NULL || out == NULL || in_fd < 0 || out_fd < 0)
+    {
+        printf("FAIL\n");
+        return;
+    }
+    for (i = 0; i < test_data->file_len; i++)
+    {
+        in[i] = 'a' + (i * 7) % 26;
+    }
+    if (write(test_data->in_pipe ? fds[1] : in_fd, in, test_data->file_len) != test_data->file_len)
+    {
+        pass = 0;
+    }
+    if (test_data->in_pipe)
+    {
+        close(fds[1]);
+    }
+    else
+    {
+        lseek(in_fd, 0, SEEK_SET);
+    }
+    circ_buf_init(&cb, buf, sizeof(buf));
+    ret = circ_relay_init(&relay, &cb, in_fd, out_fd, test_data->transform ? upper_func : NULL, &num_transformed);
+    if (ret != 0 || circ_relay_run(&relay) != 0)
+    {
+        pass = 0;
+    }
+    if (test_data->transform)
+    {
+        for (i = 0; i < test_data->file_len; i++)
+        {
+            in[i] = toupper(in[i]);
+        }
+        if (relay.copied != test_data->file_len || relay.spliced != 0 || num_transformed != test_data->file_len)
+        {
+            pass = 0;
+        }
+    }
+    else if (relay.spliced != test_data->file_len || relay.copied != 0)
+    {
+        pass = 0;
+    }
+    if (pread(out_fd, out, test_data->file_len, 0) != test_data->file_len
+     || memcmp(in, out, test_data->file_len) != 0)
+    {
+        pass = 0;
+    }
+    circ_relay_free(&relay);
+    close(out_fd);
+    close(in_fd);
+    free(out);
+    free(in);
+    printf("%s\n", pass ? "PASS" : "FAIL");
+}
+
+struct test_seq_data
+{
+    uint64_t start;
+    unsigned num_iter;
+};
+
+struct test_seq_data test_seq_data =
+{
+    .start = 0,
+    .num_iter = 3
+};
+
+struct test_seq_data test_seq_32_bit_wrap_data =
+{
+    .start = 0xfffffffdULL,
+    .num_iter = 3
+};
+
+void test_seq_func(const char *name, struct test_seq_data *test_data)
+{
+    circ_seq_buf_t cb = {0};
+    uint64_t seq = 0;
+    unsigned i = 0;
+    unsigned j = 0;
+    char buf[BUF_LEN] = {0};
+    char in[BUF_LEN] = {0};
+    char out[BUF_LEN] = {0};
+    int pass = 1;
+    int ret = 0;
+
+    printf("%-60s...", name);
+
+    circ_seq_buf_init(&cb, buf, sizeof(buf), test_data->start);
+    seq = test_data->start;
+    for (i = 0; i < test_data->num_iter; i++)
+    {
+        /* every byte of the buffer is used */
+        for (j = 0; j < BUF_LEN; j++)
+        {
+            in[j] = 'a' + i + j;
+        }
+        ret = circ_seq_buf_write(&cb, in, BUF_LEN);
+        if (ret != BUF_LEN || !circ_seq_buf_is_full(&cb) || circ_seq_buf_space(&cb) != 0
+         || circ_seq_buf_write(&cb, in, 1) != 0)
+        {
+            pass = 0;
+        }
+        /* the sequence numbers are offsets into the stream */
+        if (cb.tail != seq || cb.head != seq + BUF_LEN)
+        {
+            pass = 0;
+        }
+        /* leave some bytes behind so that the next write wraps */
+        memset(out, 0, sizeof(out));
+        ret = circ_seq_buf_read(&cb, out, BUF_LEN - 3);
+        ret += circ_seq_buf_read(&cb, out + ret, BUF_LEN);
+        if (ret != BUF_LEN || memcmp(in, out, BUF_LEN) != 0 || !circ_seq_buf_is_empty(&cb))
+        {
+            pass = 0;
+        }
+        seq += BUF_LEN;
+        ret = circ_seq_buf_write(&cb, in, 3);
+        if (ret != 3 || circ_seq_buf_consume(&cb, BUF_LEN) != 3 || cb.tail != seq + 3)
+        {
+            pass = 0;
+        }
+        seq += 3;
+    }
+    printf("%s\n", pass ? "PASS" : "FAIL");
+}
+
+struct test_seq_gap_data
+{
+    uint64_t start;
+    unsigned num_write;
+};
+
+struct test_seq_gap_data test_seq_gap_data =
+{
+    .start = 100,
+    .num_write = BUF_LEN + 5
+};
+
+struct test_seq_gap_data test_seq_gap_long_data =
+{
+    .start = 100,
+    .num_write = 3 * BUF_LEN + 5
+};
+
+void test_seq_gap_func(const char *name, struct test_seq_gap_data *test_data)
+{
+    circ_seq_buf_t cb = {0};
+    unsigned i = 0;
+    char buf[BUF_LEN] = {0};
+    char out[BUF_LEN] = {0};
+    char *in = NULL;
+    uint64_t seq = 0;
+    int pass = 1;
+    int ret = 0;
+
+    printf("%-60s...", name);
+
+    in = malloc(test_data->num_write);
+    if (in == NULL)
+    {
+        printf("FAIL\n");
+        return;
+    }
+    for (i = 0; i < test_data->num_write; i++)
+    {
+        in[i] = 'a' + i % 26;
+    }
+    circ_seq_buf_init(&cb, buf, sizeof(buf), test_data->start);
+    /* a reader that keeps its own position and has not read anything yet */
+    seq = test_data->start;
+    ret = circ_seq_buf_overwrite(&cb, in, test_data->num_write);
+    if (ret != test_data->num_write || !circ_seq_buf_is_full(&cb)
+     || cb.head != test_data->start + test_data->num_write)
+    {
+        pass = 0;
+    }
+    /* the oldest bytes have been discarded */
+    if (circ_seq_buf_peek_at(&cb, seq, out, BUF_LEN) != -ERANGE
+     || cb.tail - seq != test_data->num_write - BUF_LEN)
+    {
+        pass = 0;
+    }
+    /* the reader skips the gap and reads the newest bytes */
+    seq = cb.tail;
+    ret = circ_seq_buf_peek_at(&cb, seq, out, BUF_LEN);
+    if (ret != BUF_LEN || memcmp(out, in + test_data->num_write - BUF_LEN, BUF_LEN) != 0)
+    {
+        pass = 0;
+    }
+    ret = circ_seq_buf_peek_at(&cb, seq + 2, out, BUF_LEN);
+    if (ret != BUF_LEN - 2 || memcmp(out, in + test_data->num_write - BUF_LEN + 2, BUF_LEN - 2) != 0)
+    {
+        pass = 0;
+    }
+    if (circ_seq_buf_peek_at(&cb, cb.head, out, BUF_LEN) != 0
+     || circ_seq_buf_peek_at(&cb, cb.head + 1, out, BUF_LEN) != -EINVAL)
+    {
+        pass = 0;
+    }
+    free(in);
+    printf("%s\n", pass ? "PASS" : "FAIL");
+}
+
 int main()
 {
     test_space_func("count", &test_space_data);
@@ -469,6 +1189,19 @@ int main()
     test_peek_consume_func("peek/consume data into larger buffer", &test_peek_consume_larger_data);
     test_peek_consume_func("tail > head, peek/consume data into smaller buffer", &test_tail_gt_head_peek_consume_smaller_buffer);
     test_peek_consume_func("tail > head, peek/consume data into larger buffer", &test_tail_gt_head_peek_consume_larger_data);
+    test_mirror_func("mirrored, write and read wrapped data", &test_mirror_data);
+    test_fd_func("fill from and drain to a file descriptor", &test_fd_data);
+    test_uring_copy_func("io_uring, copy a file", &test_uring_copy_data);
+    test_uring_copy_func("io_uring, mirrored, copy a file", &test_uring_copy_mirrored_data);
+    test_uring_follow_func("io_uring, follow a growing file", &test_uring_follow_data);
+    test_uring_error_func("io_uring, keep the bytes of a failed write", &test_uring_error_data);
+    test_relay_func("relay, splice a file to a file", &test_relay_file_data);
+    test_relay_func("relay, splice a pipe to a file", &test_relay_pipe_data);
+    test_relay_func("relay, copy and transform a file to a file", &test_relay_transform_data);
+    test_seq_func("sequence, use all of the buffer", &test_seq_data);
+    test_seq_func("sequence, use all of the buffer past 32 bit offsets", &test_seq_32_bit_wrap_data);
+    test_seq_gap_func("sequence, overwrite and detect a gap", &test_seq_gap_data);
+    test_seq_gap_func("sequence, overwrite more than the buffer and detect a gap", &test_seq_gap_long_data);
 
     return 0;
 }